@@ -40,8 +40,15 @@ public class KantanDocGen : ModuleRules
                 "ImageWriteQueue",
 				"RenderCore",
 				"SlateRHIRenderer",
-				"Settings"
+				"Settings",
+				"DerivedDataCache"
             }
         );
+
+		// Watch mode regenerates docs once a live coding patch is applied
+		if (Target.Platform == UnrealTargetPlatform.Win64)
+		{
+			PrivateIncludePathModuleNames.Add("LiveCoding");
+		}
 	}
 }
@@ -0,0 +1,145 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenActionIndex.h"
+#include "BlueprintActionDatabase.h"
+#include "BlueprintNodeSpawner.h"
+#include "HAL/PlatformTime.h"
+#include "K2Node.h"
+#include "KantanDocGenLog.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectIterator.h"
+
+template <typename TActionList>
+FDocGenActionIndex::FBucket FDocGenActionIndex::AddBucket(UObject* Owner, TActionList const& Actions)
+{
+	FBucket Bucket;
+	Bucket.First = Spawners.Num();
+	Bucket.Num = Actions.Num();
+
+	Spawners.Reserve(Spawners.Num() + Actions.Num());
+	for (auto Spawner : Actions)
+	{
+		Spawners.Add(Spawner);
+	}
+	return Buckets.Add(FObjectKey(Owner), Bucket);
+}
+
+void FDocGenActionIndex::Build(TArray<FName> const& NativeModules, TArray<FName> const& InContentPaths,
+							   bool bInTargetedRefresh)
+{
+	check(IsInGameThread());
+
+	bTargetedRefresh = bInTargetedRefresh;
+
+	NativePackages.Empty(NativeModules.Num());
+	for (auto const& Module : NativeModules)
+	{
+		NativePackages.Add(FName(*(TEXT("/Script/") + Module.ToString())));
+	}
+	ContentPaths.Empty(InContentPaths.Num());
+	for (auto const& Path : InContentPaths)
+	{
+		FString PathString = Path.ToString();
+		PathString.RemoveFromEnd(TEXT("/"));
+		ContentPaths.Add(PathString + TEXT("/"));
+	}
+
+	Spawners.Reset();
+	Buckets.Reset();
+
+	double const StartTime = FPlatformTime::Seconds();
+	auto& Database = FBlueprintActionDatabase::Get();
+	if (bTargetedRefresh)
+	{
+		// Querying an empty database rebuilds it for every loaded class and asset. Instead, register the actions of
+		// the node classes, which covers those keyed on structs and enums; classes and blueprints are refreshed one
+		// at a time as they are enumerated.
+		for (TObjectIterator<UClass> It; It; ++It)
+		{
+			if (It->IsChildOf(UK2Node::StaticClass()) &&
+				!It->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+			{
+				Database.RefreshClassActions(*It);
+			}
+		}
+	}
+
+	for (auto const& Entry : Database.GetAllActions())
+	{
+		UObject* Owner = Entry.Key.ResolveObjectPtr();
+		if (Owner && Entry.Value.Num() > 0 && IsInScope(Owner) && !(bTargetedRefresh && Owner->IsA<UClass>()))
+		{
+			AddBucket(Owner, Entry.Value);
+		}
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("Indexed %d actions of %d objects in %.3fs"), Spawners.Num(), Buckets.Num(),
+		   FPlatformTime::Seconds() - StartTime);
+}
+
+FDocGenActionIndex::FBucket FDocGenActionIndex::FindOrAddBucket(UObject* Owner)
+{
+	check(IsInGameThread());
+
+	if (auto Bucket = Buckets.Find(FObjectKey(Owner)))
+	{
+		return *Bucket;
+	}
+
+	// Not loaded when the snapshot was taken, or has no actions. Either way, only look it up once.
+	auto& Database = FBlueprintActionDatabase::Get();
+	if (bTargetedRefresh)
+	{
+		if (auto Class = Cast<UClass>(Owner))
+		{
+			Database.RefreshClassActions(Class);
+		}
+		else if (Owner->IsAsset())
+		{
+			Database.RefreshAssetActions(Owner);
+		}
+	}
+	if (auto Actions = Database.GetAllActions().Find(Owner))
+	{
+		return AddBucket(Owner, *Actions);
+	}
+	return Buckets.Add(FObjectKey(Owner), FBucket());
+}
+
+UBlueprintNodeSpawner* FDocGenActionIndex::GetSpawner(int32 Index) const
+{
+	return Spawners[Index].Get();
+}
+
+int32 FDocGenActionIndex::GetNumOwners() const
+{
+	return Buckets.Num();
+}
+
+int32 FDocGenActionIndex::GetNumSpawners() const
+{
+	return Spawners.Num();
+}
+
+bool FDocGenActionIndex::IsInScope(UObject* Owner) const
+{
+	UPackage* Package = Owner->GetOutermost();
+	if (NativePackages.Contains(Package->GetFName()))
+	{
+		return true;
+	}
+
+	FString const PackageName = Package->GetName();
+	for (auto const& Path : ContentPaths)
+	{
+		if (PackageName.StartsWith(Path))
+		{
+			return true;
+		}
+	}
+	return false;
+}
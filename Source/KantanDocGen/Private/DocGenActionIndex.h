@@ -0,0 +1,62 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UBlueprintNodeSpawner;
+
+/*
+Snapshot of the blueprint action database, inverted into one bucket of spawners per owner object.
+It is built once at task start and holds only the owners within the task's modules and content paths, with every
+spawner in a single flat array, so that enumerating an object is a linear walk over its bucket.
+*/
+class FDocGenActionIndex
+{
+public:
+	/** A contiguous run of spawners belonging to one owner */
+	struct FBucket
+	{
+		int32 First = 0;
+		int32 Num = 0;
+	};
+
+public:
+	/**
+	 * Game thread only. Replaces the index with a snapshot of the actions of owners in scope.
+	 * With bInTargetedRefresh, the database is only populated for the owners doc gen asks about, rather than for
+	 * everything that is loaded. Worthwhile when nothing else has needed the database yet, as in a commandlet.
+	 */
+	void Build(TArray<FName> const& NativeModules, TArray<FName> const& InContentPaths, bool bInTargetedRefresh);
+
+	/**
+	 * Game thread only. Blueprints loaded since the snapshot are looked up in the action database on first use,
+	 * owners with no actions get an empty bucket. With targeted refresh, the owner's actions are refreshed first.
+	 */
+	FBucket FindOrAddBucket(UObject* Owner);
+
+	/** Null if the spawner has since been destroyed */
+	UBlueprintNodeSpawner* GetSpawner(int32 Index) const;
+
+	int32 GetNumOwners() const;
+	int32 GetNumSpawners() const;
+
+protected:
+	bool IsInScope(UObject* Owner) const;
+	template <typename TActionList>
+	FBucket AddBucket(UObject* Owner, TActionList const& Actions);
+
+protected:
+	bool bTargetedRefresh = false;
+	TSet<FName> NativePackages;
+	TArray<FString> ContentPaths;
+
+	TArray<TWeakObjectPtr<UBlueprintNodeSpawner>> Spawners;
+	TMap<FObjectKey, FBucket> Buckets;
+};
@@ -29,6 +29,9 @@ UDocGenCommandlet::UDocGenCommandlet()
 	HelpParamNames.Add("excludeclass");
 	HelpParamDescriptions.Add("Comma-separated list of classes to exclude");
 
+	HelpParamNames.Add("priorityclass");
+	HelpParamDescriptions.Add("Comma-separated list of classes to document first, writing their class docs early");
+
 	HelpParamNames.Add("outputdir");
 	HelpParamDescriptions.Add("Directory to place processed documentation in");
 
@@ -41,6 +44,36 @@ UDocGenCommandlet::UDocGenCommandlet()
 	HelpParamNames.Add("cleanoutput");
 	HelpParamDescriptions.Add("cleans the output directory before generating the documentation");
 
+	HelpParamNames.Add("spawnbatchsize");
+	HelpParamDescriptions.Add("Maximum number of nodes to spawn per game thread round trip");
+
+	HelpParamNames.Add("doctreethreads");
+	HelpParamDescriptions.Add("Number of workers generating node docs in parallel (0 uses one per core)");
+
+	HelpParamNames.Add("encodethreads");
+	HelpParamDescriptions.Add("Number of workers encoding node images in parallel (0 uses one per core)");
+
+	HelpParamNames.Add("queuecapacity");
+	HelpParamDescriptions.Add("Maximum number of nodes buffered between pipeline stages");
+
+	HelpParamNames.Add("batchesinflight");
+	HelpParamDescriptions.Add("Number of node batches queued on the game thread at once");
+
+	HelpParamNames.Add("gamethreadbudget");
+	HelpParamDescriptions.Add("Game thread milliseconds doc gen may use per frame (defaults to no limit)");
+
+	HelpParamNames.Add("imagecachesize");
+	HelpParamDescriptions.Add("Megabytes of node images kept between runs, 0 to render every image afresh");
+
+	HelpParamNames.Add("noddc");
+	HelpParamDescriptions.Add("Don't read or write generated docs through the derived data cache");
+
+	HelpParamNames.Add("resume");
+	HelpParamDescriptions.Add("Resume from the checkpoint left by an interrupted run instead of starting over");
+
+	HelpParamNames.Add("incremental");
+	HelpParamDescriptions.Add("Only regenerate the docs of nodes and classes that changed since the last run");
+
 	HelpParamNames.Add("template");
 	HelpParamDescriptions.Add("Path to the template file to use when rendering output for formats that require it");
 }
@@ -58,6 +91,8 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 	Settings.DocumentationTitle = FApp::GetProjectName();
 	Settings.OutputDirectory.Path = FPaths::ProjectSavedDir() / TEXT("KantanDocGen");
 	Settings.BlueprintContextClass = AActor::StaticClass();
+	// Nothing else needs the game thread
+	Settings.GameThreadBudgetMs = 0.0f;
 
 	if (ParsedParams.Contains("doctitle"))
 	{
@@ -104,6 +139,16 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 		}
 	}
 
+	if (ParsedParams.Contains("priorityclass"))
+	{
+		TArray<FString> Values;
+		ParsedParams["priorityclass"].ParseIntoArray(Values, TEXT(","));
+		for (const auto& Value : Values)
+		{
+			Settings.PriorityClasses.Add(FName(Value));
+		}
+	}
+
 	if (ParsedParams.Contains("outputdir"))
 	{
 		Settings.OutputDirectory.Path = ParsedParams["outputdir"];
@@ -136,6 +181,56 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 	{
 		Settings.bCleanOutputDirectory = true;
 	}
+
+	if (ParsedParams.Contains("gamethreadbudget"))
+	{
+		Settings.GameThreadBudgetMs = FMath::Max(0.0f, FCString::Atof(*ParsedParams["gamethreadbudget"]));
+	}
+
+	if (ParsedParams.Contains("imagecachesize"))
+	{
+		Settings.ImageCacheSizeMB = FMath::Max(0, FCString::Atoi(*ParsedParams["imagecachesize"]));
+	}
+
+	if (Switches.Contains("resume"))
+	{
+		Settings.bResumeFromCheckpoint = true;
+	}
+
+	if (Switches.Contains("noddc"))
+	{
+		Settings.bUseDerivedDataCache = false;
+	}
+
+	if (Switches.Contains("incremental"))
+	{
+		Settings.bIncremental = true;
+	}
+
+	if (ParsedParams.Contains("spawnbatchsize"))
+	{
+		Settings.NodeSpawnBatchSize = FMath::Max(1, FCString::Atoi(*ParsedParams["spawnbatchsize"]));
+	}
+
+	if (ParsedParams.Contains("doctreethreads"))
+	{
+		Settings.DocTreeWorkerThreads = FMath::Max(0, FCString::Atoi(*ParsedParams["doctreethreads"]));
+	}
+
+	if (ParsedParams.Contains("encodethreads"))
+	{
+		Settings.ImageEncodeWorkerThreads = FMath::Max(0, FCString::Atoi(*ParsedParams["encodethreads"]));
+	}
+
+	if (ParsedParams.Contains("queuecapacity"))
+	{
+		Settings.PipelineQueueCapacity = FMath::Max(1, FCString::Atoi(*ParsedParams["queuecapacity"]));
+	}
+
+	if (ParsedParams.Contains("batchesinflight"))
+	{
+		Settings.GameThreadBatchesInFlight = FMath::Max(1, FCString::Atoi(*ParsedParams["batchesinflight"]));
+	}
 	auto& Module = FModuleManager::LoadModuleChecked<FKantanDocGenModule>(TEXT("KantanDocGen"));
 	auto GenerateDocsResult = Module.GenerateDocs(Settings);
 	while (!GenerateDocsResult.IsReady())
@@ -0,0 +1,112 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenDerivedData.h"
+#include "DerivedDataCacheInterface.h"
+#include "DocTreeNode.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace DocGenDerivedData
+{
+	static const TCHAR* KeyPrefix = TEXT("KANTANDOCGEN");
+	// Bump whenever the stored artifacts change in a way their content hashes can't see
+	static const TCHAR* FormatVersion = TEXT("1");
+	// Doc trees are prefixed with a marker, so a stale or foreign entry is rejected rather than misread
+	static const uint32 DocTreeMagic = 0x4B444754;
+} // namespace DocGenDerivedData
+
+FDocGenDerivedData::FDocGenDerivedData()
+{
+	FString PluginVersion = TEXT("Unknown");
+	if (auto Plugin = IPluginManager::Get().FindPlugin(TEXT("KantanDocGen")))
+	{
+		PluginVersion = Plugin->GetDescriptor().VersionName;
+	}
+	Version = FString::Printf(TEXT("%s_%s_%s"), DocGenDerivedData::FormatVersion, *PluginVersion,
+							  *FEngineVersion::Current().ToString(EVersionComponent::Changelist));
+}
+
+bool FDocGenDerivedData::ProbablyHas(TCHAR const* Kind, FString const& Hash) const
+{
+	return GetDerivedDataCacheRef().CachedDataProbablyExists(*MakeKey(Kind, Hash));
+}
+
+TBitArray<> FDocGenDerivedData::ProbablyHasBatch(TCHAR const* Kind, TArray<FString> const& Hashes) const
+{
+	TArray<FString> Keys;
+	Keys.Reserve(Hashes.Num());
+	for (FString const& Hash : Hashes)
+	{
+		Keys.Add(MakeKey(Kind, Hash));
+	}
+#if UE_VERSION_OLDER_THAN(4, 26, 0)
+	TBitArray<> Result;
+	for (FString const& Key : Keys)
+	{
+		Result.Add(GetDerivedDataCacheRef().CachedDataProbablyExists(*Key));
+	}
+	return Result;
+#else
+	return GetDerivedDataCacheRef().CachedDataProbablyExistsBatch(Keys);
+#endif
+}
+
+bool FDocGenDerivedData::Get(TCHAR const* Kind, FString const& Hash, TArray<uint8>& OutData) const
+{
+#if UE_VERSION_OLDER_THAN(4, 26, 0)
+	return GetDerivedDataCacheRef().GetSynchronous(*MakeKey(Kind, Hash), OutData);
+#else
+	return GetDerivedDataCacheRef().GetSynchronous(*MakeKey(Kind, Hash), OutData, TEXT("KantanDocGen"));
+#endif
+}
+
+void FDocGenDerivedData::Put(TCHAR const* Kind, FString const& Hash, TArray<uint8> const& Data) const
+{
+#if UE_VERSION_OLDER_THAN(4, 26, 0)
+	TArray<uint8> DataCopy = Data;
+	GetDerivedDataCacheRef().Put(*MakeKey(Kind, Hash), DataCopy);
+#else
+	GetDerivedDataCacheRef().Put(*MakeKey(Kind, Hash), Data, TEXT("KantanDocGen"));
+#endif
+}
+
+TSharedPtr<DocTreeNode> FDocGenDerivedData::GetDocTree(TCHAR const* Kind, FString const& Hash) const
+{
+	TArray<uint8> Data;
+	if (!Get(Kind, Hash, Data))
+	{
+		return nullptr;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	Reader << Magic;
+	if (Magic != DocGenDerivedData::DocTreeMagic)
+	{
+		return nullptr;
+	}
+	return DocTreeNode::Load(Reader);
+}
+
+void FDocGenDerivedData::PutDocTree(TCHAR const* Kind, FString const& Hash, TSharedPtr<DocTreeNode> const& Tree) const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = DocGenDerivedData::DocTreeMagic;
+	Writer << Magic;
+	Tree->Save(Writer);
+	Put(Kind, Hash, Data);
+}
+
+FString FDocGenDerivedData::MakeKey(TCHAR const* Kind, FString const& Hash) const
+{
+	return FDerivedDataCacheInterface::BuildCacheKey(DocGenDerivedData::KeyPrefix, *Version,
+													 *FString::Printf(TEXT("%s_%s"), Kind, *Hash));
+}
@@ -0,0 +1,40 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class DocTreeNode;
+
+/*
+Generated doc artifacts stored through the engine's derived data cache, so that any DDC the editor is set up with,
+whether a local directory or one shared between machines, can serve node images and doc trees to other projects.
+Artifacts are keyed on a content hash, and the keys are versioned by plugin and engine version. Callable from any
+thread; lookups are synchronous, so avoid them on the game thread where possible.
+*/
+class FDocGenDerivedData
+{
+public:
+	FDocGenDerivedData();
+
+	/** Cheap check, suitable for the game thread with a local DDC, that may give false positives */
+	bool ProbablyHas(TCHAR const* Kind, FString const& Hash) const;
+	/** ProbablyHas for many hashes in one round trip to the cache. One bit per hash, in order. */
+	TBitArray<> ProbablyHasBatch(TCHAR const* Kind, TArray<FString> const& Hashes) const;
+	bool Get(TCHAR const* Kind, FString const& Hash, TArray<uint8>& OutData) const;
+	void Put(TCHAR const* Kind, FString const& Hash, TArray<uint8> const& Data) const;
+
+	/** Null if the tree isn't cached */
+	TSharedPtr<DocTreeNode> GetDocTree(TCHAR const* Kind, FString const& Hash) const;
+	void PutDocTree(TCHAR const* Kind, FString const& Hash, TSharedPtr<DocTreeNode> const& Tree) const;
+
+protected:
+	FString MakeKey(TCHAR const* Kind, FString const& Hash) const;
+
+protected:
+	FString Version;
+};
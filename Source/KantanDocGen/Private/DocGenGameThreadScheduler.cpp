@@ -0,0 +1,56 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenGameThreadScheduler.h"
+#include "HAL/PlatformTime.h"
+
+FDocGenGameThreadScheduler::FDocGenGameThreadScheduler()
+	: FrameBudget(0.0)
+	, FrameDeadline(0.0)
+{
+	check(IsInGameThread());
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FDocGenGameThreadScheduler::Tick), 0.0f);
+}
+
+FDocGenGameThreadScheduler::~FDocGenGameThreadScheduler()
+{
+	check(IsInGameThread());
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+void FDocGenGameThreadScheduler::SetFrameBudget(double Seconds)
+{
+	FrameBudget = FMath::Max(0.0, Seconds);
+}
+
+void FDocGenGameThreadScheduler::Enqueue(TFunction<void()> Work)
+{
+	Pending.Enqueue(MoveTemp(Work));
+}
+
+double FDocGenGameThreadScheduler::GetRemainingBudget() const
+{
+	return FrameBudget > 0.0 ? FrameDeadline - FPlatformTime::Seconds() : MAX_dbl;
+}
+
+bool FDocGenGameThreadScheduler::Tick(float DeltaTime)
+{
+	FrameDeadline = FPlatformTime::Seconds() + FrameBudget;
+
+	TFunction<void()> Work;
+	while (Pending.Dequeue(Work))
+	{
+		Work();
+		if (GetRemainingBudget() <= 0.0)
+		{
+			break;
+		}
+	}
+
+	// Keep ticking for as long as the scheduler exists
+	return true;
+}
@@ -0,0 +1,64 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "Templates/SharedPointer.h"
+
+/*
+Runs doc gen work on the game thread from the core ticker, a slice at a time, so that the editor stays responsive.
+Each frame it runs queued work until the frame budget is used up; work can check the remaining budget to size
+itself accordingly. At least one item runs per frame, so progress is made however small the budget.
+*/
+class FDocGenGameThreadScheduler
+{
+public:
+	/** Must be constructed and destroyed on the game thread */
+	FDocGenGameThreadScheduler();
+	~FDocGenGameThreadScheduler();
+
+	/** Game thread time given to doc gen per frame. 0 removes the limit. */
+	void SetFrameBudget(double Seconds);
+
+	/** Queues Work to run on the game thread. Callable from any thread. */
+	void Enqueue(TFunction<void()> Work);
+
+	/** Seconds left of the current frame's budget. Callable from queued work. */
+	double GetRemainingBudget() const;
+
+	/**
+	 * Queues GameThreadFunc, then passes its result to Continuation on a background task.
+	 * Neither thread waits on the other.
+	 */
+	template <typename TGameThreadFunc, typename TContinuation>
+	void RunThen(TGameThreadFunc GameThreadFunc, TContinuation Continuation)
+	{
+		Enqueue([GameThreadFunc, Continuation] {
+			typedef decltype(GameThreadFunc()) TResult;
+
+			TSharedRef<TOptional<TResult>, ESPMode::ThreadSafe> Result =
+				MakeShared<TOptional<TResult>, ESPMode::ThreadSafe>();
+			Result->Emplace(GameThreadFunc());
+			FFunctionGraphTask::CreateAndDispatchWhenReady(
+				[Result, Continuation] { Continuation(MoveTemp(Result->GetValue())); }, TStatId(), nullptr,
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+		});
+	}
+
+protected:
+	bool Tick(float DeltaTime);
+
+protected:
+	TQueue<TFunction<void()>, EQueueMode::Mpsc> Pending;
+	FDelegateHandle TickerHandle;
+	double FrameBudget;
+	double FrameDeadline;
+};
@@ -0,0 +1,159 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenImageCache.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+FDocGenImageCache::FDocGenImageCache(FString const& InCacheDir)
+	: CacheDir(InCacheDir)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	TArray<FString> Files;
+	FileManager.FindFilesRecursive(Files, *CacheDir, TEXT("*.png"), true, false);
+	for (FString const& File : Files)
+	{
+		FEntry Entry;
+		Entry.Size = FileManager.FileSize(*File);
+		Entry.LastUsed = FileManager.GetTimeStamp(*File);
+		if (Entry.Size > 0)
+		{
+			Entries.Add(FPaths::GetBaseFilename(File), Entry);
+			TotalSize += Entry.Size;
+		}
+	}
+	UE_LOG(LogKantanDocGen, Display, TEXT("Image cache %s holds %d images (%.1f MB)"), *CacheDir, Entries.Num(),
+		   TotalSize / (1024.0 * 1024.0));
+}
+
+void FDocGenImageCache::SetMaxSize(int64 InMaxSizeBytes)
+{
+	TArray<FString> Evicted;
+	{
+		FScopeLock Lock(&CS);
+		MaxSizeBytes = InMaxSizeBytes;
+		Evicted = Trim();
+	}
+	DeleteFiles(Evicted);
+}
+
+bool FDocGenImageCache::Contains(FString const& Key)
+{
+	FScopeLock Lock(&CS);
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		Entry->LastUsed = FDateTime::UtcNow();
+		return true;
+	}
+	Misses.Increment();
+	return false;
+}
+
+bool FDocGenImageCache::Retrieve(FString const& Key, FString const& DestFile)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	FString const CacheFile = GetCacheFile(Key);
+	if (FileManager.Copy(*DestFile, *CacheFile, true) == COPY_OK)
+	{
+		// Persist the use, so that eviction order survives between sessions
+		FileManager.SetTimeStamp(*CacheFile, FDateTime::UtcNow());
+		Hits.Increment();
+		return true;
+	}
+
+	UE_LOG(LogKantanDocGen, Verbose, TEXT("Cached node image %s has gone"), *CacheFile);
+	Misses.Increment();
+	FScopeLock Lock(&CS);
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Key, Entry))
+	{
+		TotalSize -= Entry.Size;
+	}
+	return false;
+}
+
+void FDocGenImageCache::Store(FString const& Key, FString const& SourceFile)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	FString const CacheFile = GetCacheFile(Key);
+	// Copy alongside and swap in, so a reader never sees a partial image
+	FString const TempFile = CacheFile + TEXT(".tmp");
+	if (FileManager.Copy(*TempFile, *SourceFile, true) != COPY_OK || !FileManager.Move(*CacheFile, *TempFile, true))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to add node image %s to the cache"), *SourceFile);
+		return;
+	}
+
+	FEntry NewEntry;
+	NewEntry.Size = FileManager.FileSize(*CacheFile);
+	NewEntry.LastUsed = FDateTime::UtcNow();
+
+	TArray<FString> Evicted;
+	{
+		FScopeLock Lock(&CS);
+		if (FEntry* Entry = Entries.Find(Key))
+		{
+			TotalSize -= Entry->Size;
+		}
+		Entries.Add(Key, NewEntry);
+		TotalSize += NewEntry.Size;
+		Stored.Increment();
+		Evicted = Trim();
+	}
+	DeleteFiles(Evicted);
+}
+
+FString FDocGenImageCache::DescribeStats() const
+{
+	FScopeLock Lock(&CS);
+	return FString::Printf(TEXT("Image cache: %d hits, %d misses, %d stored, %d images (%.1f of %.1f MB)"),
+						   Hits.GetValue(), Misses.GetValue(), Stored.GetValue(), Entries.Num(),
+						   TotalSize / (1024.0 * 1024.0), MaxSizeBytes / (1024.0 * 1024.0));
+}
+
+void FDocGenImageCache::ResetStats()
+{
+	Hits.Reset();
+	Misses.Reset();
+	Stored.Reset();
+}
+
+FString FDocGenImageCache::GetCacheFile(FString const& Key) const
+{
+	// Spread across subdirectories, to keep any one directory listing small
+	return CacheDir / Key.Left(2) / Key + TEXT(".png");
+}
+
+TArray<FString> FDocGenImageCache::Trim()
+{
+	TArray<FString> Evicted;
+	if (TotalSize <= MaxSizeBytes)
+	{
+		return Evicted;
+	}
+
+	// Trim to below the limit, so that the next few stores don't each have to sort the whole cache again
+	int64 const TargetSize = MaxSizeBytes - MaxSizeBytes / 10;
+	Entries.ValueSort([](FEntry const& A, FEntry const& B) { return A.LastUsed < B.LastUsed; });
+	for (auto It = Entries.CreateIterator(); It && TotalSize > TargetSize; ++It)
+	{
+		Evicted.Add(GetCacheFile(It.Key()));
+		TotalSize -= It.Value().Size;
+		It.RemoveCurrent();
+	}
+	return Evicted;
+}
+
+void FDocGenImageCache::DeleteFiles(TArray<FString> const& Files)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	for (FString const& File : Files)
+	{
+		FileManager.Delete(*File, false, true, true);
+	}
+}
@@ -0,0 +1,64 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+
+/*
+Node images kept between runs, keyed on a hash of everything that affects how the node widget renders.
+The cache is a directory of PNGs which persists across runs and documentation sets; once it grows past its size
+limit, the least recently used images are evicted, down to a little under the limit so that eviction is occasional
+rather than on every store. Callable from any thread.
+*/
+class FDocGenImageCache
+{
+public:
+	/** Scans the images already in CacheDir, so best constructed off the game thread */
+	FDocGenImageCache(FString const& InCacheDir);
+
+	/** Sets the size limit, evicting images as needed to fit */
+	void SetMaxSize(int64 InMaxSizeBytes);
+
+	/**
+	 * Whether Key is cached. A found image is marked as used, so it is among the last to be evicted, but it may still
+	 * be gone by the time it is retrieved.
+	 */
+	bool Contains(FString const& Key);
+	/** Copies the cached image into place. On failure, Key is dropped from the cache and counted as a miss. */
+	bool Retrieve(FString const& Key, FString const& DestFile);
+	/** Copies a freshly written image into the cache */
+	void Store(FString const& Key, FString const& SourceFile);
+
+	/** Hits and stores since the last ResetStats, for the log */
+	FString DescribeStats() const;
+	void ResetStats();
+
+protected:
+	FString GetCacheFile(FString const& Key) const;
+	// Caller must hold CS. Returns the files of evicted images, to be deleted once the lock is released.
+	TArray<FString> Trim();
+	static void DeleteFiles(TArray<FString> const& Files);
+
+protected:
+	struct FEntry
+	{
+		int64 Size = 0;
+		FDateTime LastUsed;
+	};
+
+	FString CacheDir;
+	mutable FCriticalSection CS;
+	TMap<FString, FEntry> Entries;
+	int64 TotalSize = 0;
+	int64 MaxSizeBytes = 0;
+
+	FThreadSafeCounter Hits;
+	FThreadSafeCounter Misses;
+	FThreadSafeCounter Stored;
+};
@@ -0,0 +1,288 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenJournal.h"
+#include "DocGenSettings.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "OutputFormats/DocGenOutputFormatFactoryBase.h"
+
+namespace DocGenJournal
+{
+	static const TCHAR* FileName = TEXT("journal.txt");
+	static const TCHAR* Header = TEXT("KantanDocGenJournal");
+	static const TCHAR* Version = TEXT("1");
+	static const TCHAR* ObjectEntry = TEXT("O");
+	static const TCHAR* NodeEntry = TEXT("N");
+
+	// Fields are tab separated, one entry per line
+	static FString SanitizeField(FString const& Field)
+	{
+		return Field.Replace(TEXT("\t"), TEXT(" ")).Replace(TEXT("\r"), TEXT(" ")).Replace(TEXT("\n"), TEXT(" "));
+	}
+} // namespace DocGenJournal
+
+FDocGenJournal::FDocGenJournal(FString const& InIntermediateDir, FString const& InSettingsSignature)
+	: JournalFile(InIntermediateDir / DocGenJournal::FileName)
+	, SettingsSignature(InSettingsSignature)
+	, Writer(nullptr)
+{}
+
+FDocGenJournal::~FDocGenJournal()
+{
+	delete Writer;
+}
+
+bool FDocGenJournal::Load()
+{
+	FScopeLock Lock(&CS);
+	CompleteObjects.Empty();
+	CompletedNodes.Empty();
+
+	FString Contents;
+	if (!FFileHelper::LoadFileToString(Contents, *JournalFile))
+	{
+		return false;
+	}
+
+	// A run killed part way through writing may have left a torn final entry
+	int32 LastLineEnd = INDEX_NONE;
+	if (!Contents.FindLastChar(TEXT('\n'), LastLineEnd))
+	{
+		return false;
+	}
+	Contents.LeftInline(LastLineEnd + 1, false);
+
+	TArray<FString> Lines;
+	Contents.ParseIntoArrayLines(Lines);
+
+	TArray<FString> Fields;
+	if (Lines.Num() == 0 || Lines[0].ParseIntoArray(Fields, TEXT("\t"), false) != 3 ||
+		Fields[0] != DocGenJournal::Header || Fields[1] != DocGenJournal::Version || Fields[2] != SettingsSignature)
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Ignoring journal %s left by a run with different settings"),
+			   *JournalFile);
+		return false;
+	}
+
+	// Nodes are only kept if their object completed; the rest will be generated again
+	TArray<TPair<FString, FNodeDocsGenerator::FDocumentedNode>> Nodes;
+	for (int32 Index = 1; Index < Lines.Num(); ++Index)
+	{
+		Lines[Index].ParseIntoArray(Fields, TEXT("\t"), false);
+		if (Fields.Num() == 2 && Fields[0] == DocGenJournal::ObjectEntry)
+		{
+			CompleteObjects.Add(Fields[1]);
+		}
+		else if (Fields.Num() == 6 && Fields[0] == DocGenJournal::NodeEntry)
+		{
+			FNodeDocsGenerator::FDocumentedNode Node;
+			Node.ClassId = Fields[2];
+			Node.ClassDisplayName = Fields[3];
+			Node.NodeId = Fields[4];
+			Node.ShortTitle = Fields[5];
+			Nodes.Emplace(Fields[1], MoveTemp(Node));
+		}
+	}
+
+	for (auto& Entry : Nodes)
+	{
+		if (CompleteObjects.Contains(Entry.Key))
+		{
+			CompletedNodes.Add(MoveTemp(Entry.Value));
+		}
+	}
+
+	return CompleteObjects.Num() > 0;
+}
+
+bool FDocGenJournal::Open(bool bResume)
+{
+	FScopeLock Lock(&CS);
+	delete Writer;
+	Writer = nullptr;
+
+	if (!bResume)
+	{
+		CompleteObjects.Empty();
+		CompletedNodes.Empty();
+		IFileManager::Get().Delete(*JournalFile, false, true, true);
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(JournalFile), true);
+	Writer = IFileManager::Get().CreateFileWriter(*JournalFile, FILEWRITE_Append | FILEWRITE_AllowRead);
+	if (Writer == nullptr)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to open journal %s"), *JournalFile);
+		return false;
+	}
+
+	if (!bResume)
+	{
+		WriteLine({DocGenJournal::Header, DocGenJournal::Version, SettingsSignature});
+	}
+	else
+	{
+		// Drop any torn entry so that new entries start on a line of their own
+		WriteLine({});
+	}
+	return true;
+}
+
+void FDocGenJournal::Discard()
+{
+	FScopeLock Lock(&CS);
+	delete Writer;
+	Writer = nullptr;
+	IFileManager::Get().Delete(*JournalFile, false, true, true);
+}
+
+bool FDocGenJournal::IsObjectComplete(FString const& ObjectPath) const
+{
+	FScopeLock Lock(&CS);
+	return CompleteObjects.Contains(ObjectPath);
+}
+
+int32 FDocGenJournal::GetNumCompleteObjects() const
+{
+	FScopeLock Lock(&CS);
+	return CompleteObjects.Num();
+}
+
+TArray<FNodeDocsGenerator::FDocumentedNode> const& FDocGenJournal::GetCompletedNodes() const
+{
+	return CompletedNodes;
+}
+
+void FDocGenJournal::BeginObject(FString const& ObjectPath)
+{
+	FScopeLock Lock(&CS);
+	InProgress.Add(ObjectPath, FObjectProgress());
+}
+
+void FDocGenJournal::AddNode(FString const& ObjectPath)
+{
+	FScopeLock Lock(&CS);
+	if (auto Progress = InProgress.Find(ObjectPath))
+	{
+		++Progress->Outstanding;
+	}
+}
+
+void FDocGenJournal::NodeFinished(FString const& ObjectPath, FNodeDocsGenerator::FDocumentedNode const* Documented)
+{
+	bool bCompleted = false;
+	{
+		FScopeLock Lock(&CS);
+		auto Progress = InProgress.Find(ObjectPath);
+		if (Progress == nullptr)
+		{
+			return;
+		}
+
+		if (Documented && !Documented->NodeId.IsEmpty())
+		{
+			WriteLine({DocGenJournal::NodeEntry, ObjectPath, Documented->ClassId, Documented->ClassDisplayName,
+					   Documented->NodeId, Documented->ShortTitle});
+		}
+		--Progress->Outstanding;
+		bCompleted = CompleteObjectIfDone(ObjectPath);
+	}
+	// Outside the lock, so that the handler is free to take its time
+	if (bCompleted)
+	{
+		OnObjectComplete.ExecuteIfBound(ObjectPath);
+	}
+}
+
+void FDocGenJournal::EndObject(FString const& ObjectPath)
+{
+	bool bCompleted = false;
+	{
+		FScopeLock Lock(&CS);
+		if (auto Progress = InProgress.Find(ObjectPath))
+		{
+			Progress->bEnded = true;
+			bCompleted = CompleteObjectIfDone(ObjectPath);
+		}
+	}
+	if (bCompleted)
+	{
+		OnObjectComplete.ExecuteIfBound(ObjectPath);
+	}
+}
+
+bool FDocGenJournal::CompleteObjectIfDone(FString const& ObjectPath)
+{
+	auto Progress = InProgress.Find(ObjectPath);
+	if (Progress && Progress->bEnded && Progress->Outstanding <= 0)
+	{
+		InProgress.Remove(ObjectPath);
+		CompleteObjects.Add(ObjectPath);
+		WriteLine({DocGenJournal::ObjectEntry, ObjectPath});
+		return true;
+	}
+	return false;
+}
+
+void FDocGenJournal::WriteLine(TArray<FString> const& Fields)
+{
+	if (Writer == nullptr)
+	{
+		return;
+	}
+
+	FString Line;
+	for (auto const& Field : Fields)
+	{
+		if (!Line.IsEmpty())
+		{
+			Line += TEXT("\t");
+		}
+		Line += DocGenJournal::SanitizeField(Field);
+	}
+	Line += TEXT("\n");
+
+	FTCHARToUTF8 Utf8Line(*Line);
+	Writer->Serialize(const_cast<ANSICHAR*>(Utf8Line.Get()), Utf8Line.Length());
+	// Flush every entry, the journal is only useful if it survives the process dying
+	Writer->Flush();
+}
+
+FString FDocGenJournal::MakeSettingsSignature(FKantanDocGenSettings const& Settings)
+{
+	FString Signature = Settings.DocumentationTitle;
+	for (auto const& Module : Settings.NativeModules)
+	{
+		Signature += TEXT("|M:") + Module.ToString();
+	}
+	for (auto const& Path : Settings.ContentPaths)
+	{
+		Signature += TEXT("|P:") + Path.Path;
+	}
+	for (auto const& Class : Settings.SpecificClasses)
+	{
+		Signature += TEXT("|C:") + Class.ToString();
+	}
+	for (auto const& Class : Settings.ExcludedClasses)
+	{
+		Signature += TEXT("|X:") + Class.ToString();
+	}
+	Signature += TEXT("|B:") + GetPathNameSafe(Settings.BlueprintContextClass.Get());
+	for (auto const& Format : Settings.OutputFormats)
+	{
+		if (Format)
+		{
+			Signature += TEXT("|F:") + Format->GetFormatIdentifier();
+		}
+	}
+
+	return FString::Printf(TEXT("%08x"), FCrc::StrCrc32(*Signature));
+}
@@ -0,0 +1,76 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "NodeDocsGenerator.h"
+
+class FArchive;
+struct FKantanDocGenSettings;
+
+/*
+Append-only record of finished work, kept in the intermediate directory so that an interrupted run can carry on where
+it stopped instead of starting over.
+A source object is only recorded as complete once every node spawned for it has left the pipeline, and each entry
+is flushed as it is written, so a run killed at any point leaves a journal that is safe to resume from.
+*/
+class FDocGenJournal
+{
+public:
+	FDocGenJournal(FString const& InIntermediateDir, FString const& InSettingsSignature);
+	~FDocGenJournal();
+
+	/** Reads the journal left by an earlier run with the same settings. Returns false if there is nothing to resume. */
+	bool Load();
+	/** Opens the journal for writing. Unless resuming, any earlier journal is replaced. */
+	bool Open(bool bResume);
+	/** Deletes the journal once its run has completed */
+	void Discard();
+
+	/** Callable from any thread */
+	bool IsObjectComplete(FString const& ObjectPath) const;
+	int32 GetNumCompleteObjects() const;
+	/** Nodes of the complete objects read by Load */
+	TArray<FNodeDocsGenerator::FDocumentedNode> const& GetCompletedNodes() const;
+
+	/** Progress tracking, callable from any thread. An object completes once ended with no nodes outstanding. */
+	void BeginObject(FString const& ObjectPath);
+	void AddNode(FString const& ObjectPath);
+	/** Documented is null if the node was dropped without producing docs */
+	void NodeFinished(FString const& ObjectPath, FNodeDocsGenerator::FDocumentedNode const* Documented);
+	void EndObject(FString const& ObjectPath);
+	/**/
+
+	/** Fired once an object completes, on whichever thread finished it */
+	DECLARE_DELEGATE_OneParam(FOnObjectComplete, FString const& /* ObjectPath */);
+	FOnObjectComplete OnObjectComplete;
+
+	/** Identifies the settings that affect what is generated, so that a journal is never resumed by a different run */
+	static FString MakeSettingsSignature(FKantanDocGenSettings const& Settings);
+
+protected:
+	struct FObjectProgress
+	{
+		int32 Outstanding = 0;
+		bool bEnded = false;
+	};
+
+	// Caller must hold CS. Returns true if the object completed.
+	bool CompleteObjectIfDone(FString const& ObjectPath);
+	void WriteLine(TArray<FString> const& Fields);
+
+protected:
+	FString JournalFile;
+	FString SettingsSignature;
+
+	mutable FCriticalSection CS;
+	FArchive* Writer;
+	TSet<FString> CompleteObjects;
+	TArray<FNodeDocsGenerator::FDocumentedNode> CompletedNodes;
+	TMap<FString, FObjectProgress> InProgress;
+};
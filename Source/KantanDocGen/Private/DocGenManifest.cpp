@@ -0,0 +1,458 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenManifest.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/Archive.h"
+
+namespace DocGenManifest
+{
+	static const TCHAR* FileName = TEXT("manifest.txt");
+	static const TCHAR* Header = TEXT("KantanDocGenManifest");
+	// Bump whenever the generated docs change for reasons the hashes can't see
+	static const TCHAR* Version = TEXT("2");
+	static const TCHAR* NodeEntry = TEXT("N");
+	static const TCHAR* ClassEntry = TEXT("C");
+	static const TCHAR* TypeEntry = TEXT("T");
+	static const TCHAR* DependencyEntry = TEXT("D");
+	// Object paths can't contain commas
+	static const TCHAR* DependencySeparator = TEXT(",");
+	static const TCHAR* PackagesFileName = TEXT("packages.bin");
+	static const uint32 PackagesMagic = 0x4B444750;
+
+	template <typename TElement, typename TSerializeElement>
+	static void SerializeArray(FArchive& Ar, TArray<TElement>& Array, TSerializeElement SerializeElement)
+	{
+		int32 Num = Array.Num();
+		Ar << Num;
+		if (Ar.IsLoading())
+		{
+			// Guard against a corrupt count
+			if (Ar.IsError() || Num < 0 || Num > Ar.TotalSize())
+			{
+				Ar.SetError();
+				return;
+			}
+			Array.SetNum(Num);
+		}
+		for (TElement& Element : Array)
+		{
+			SerializeElement(Ar, Element);
+		}
+	}
+
+	static void SerializeNode(FArchive& Ar, FNodeDocsGenerator::FDocumentedNode& Node)
+	{
+		Ar << Node.ClassId << Node.ClassDisplayName << Node.NodeId << Node.ShortTitle << Node.ImageFile;
+	}
+
+	static void SerializeType(FArchive& Ar, FNodeDocsGenerator::FTypeSnapshot& Type)
+	{
+		using FTypeSnapshot = FNodeDocsGenerator::FTypeSnapshot;
+
+		uint8 Kind = (uint8) Type.Kind;
+		Ar << Kind;
+		Type.Kind = (FTypeSnapshot::EKind) Kind;
+		Ar << Type.Id << Type.DisplayName << Type.Comment;
+		SerializeArray(Ar, Type.Fields, [](FArchive& FieldAr, FTypeSnapshot::FField& Field) {
+			FieldAr << Field.Name << Field.Type << Field.Comment;
+		});
+		SerializeArray(Ar, Type.Values, [](FArchive& ValueAr, FTypeSnapshot::FEnumValue& Value) {
+			ValueAr << Value.Name << Value.DisplayName << Value.Description;
+		});
+	}
+} // namespace DocGenManifest
+
+FDocGenManifest::FDocGenManifest(FString const& InIntermediateDir, FString const& InSettingsSignature)
+	: ManifestFile(InIntermediateDir / DocGenManifest::FileName)
+	, PackagesFile(InIntermediateDir / DocGenManifest::PackagesFileName)
+	, SettingsSignature(InSettingsSignature)
+{}
+
+bool FDocGenManifest::Load()
+{
+	FScopeLock Lock(&CS);
+	PreviousNodes.Empty();
+	PreviousClasses.Empty();
+	PreviousPackages.Empty();
+	PreviousTypes.Empty();
+	PreviousDependencies.Empty();
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *ManifestFile))
+	{
+		return false;
+	}
+
+	TArray<FString> Fields;
+	if (Lines.Num() == 0 || Lines[0].ParseIntoArray(Fields, TEXT("\t"), false) != 3 ||
+		Fields[0] != DocGenManifest::Header || Fields[1] != DocGenManifest::Version || Fields[2] != SettingsSignature)
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Ignoring manifest %s left by a run with different settings"),
+			   *ManifestFile);
+		return false;
+	}
+
+	for (int32 Index = 1; Index < Lines.Num(); ++Index)
+	{
+		if (Lines[Index].ParseIntoArray(Fields, TEXT("\t"), false) != 3)
+		{
+			continue;
+		}
+		if (Fields[0] == DocGenManifest::NodeEntry)
+		{
+			PreviousNodes.Add(Fields[1], Fields[2]);
+		}
+		else if (Fields[0] == DocGenManifest::ClassEntry)
+		{
+			PreviousClasses.Add(Fields[1], Fields[2]);
+		}
+		else if (Fields[0] == DocGenManifest::TypeEntry)
+		{
+			PreviousTypes.Add(Fields[1], Fields[2]);
+		}
+		else if (Fields[0] == DocGenManifest::DependencyEntry)
+		{
+			Fields[2].ParseIntoArray(PreviousDependencies.Add(Fields[1]), DocGenManifest::DependencySeparator);
+		}
+	}
+
+	// Without package entries, every package is just loaded again
+	if (!LoadPackages())
+	{
+		PreviousPackages.Empty();
+	}
+	return true;
+}
+
+bool FDocGenManifest::Save() const
+{
+	FScopeLock Lock(&CS);
+	FString Contents = FString::Printf(TEXT("%s\t%s\t%s\n"), DocGenManifest::Header, DocGenManifest::Version,
+									   *SettingsSignature);
+	for (auto const& Entry : CurrentClasses)
+	{
+		Contents += FString::Printf(TEXT("%s\t%s\t%s\n"), DocGenManifest::ClassEntry, *Entry.Key, *Entry.Value);
+	}
+	for (auto const& Entry : CurrentNodes)
+	{
+		Contents += FString::Printf(TEXT("%s\t%s\t%s\n"), DocGenManifest::NodeEntry, *Entry.Key, *Entry.Value);
+	}
+	// Only the types something still depends on
+	TSet<FString> DependedOn;
+	for (auto const& Entry : CurrentDependencies)
+	{
+		Contents += FString::Printf(TEXT("%s\t%s\t%s\n"), DocGenManifest::DependencyEntry, *Entry.Key,
+									*FString::Join(Entry.Value, DocGenManifest::DependencySeparator));
+		DependedOn.Append(Entry.Value);
+	}
+	for (auto const& Entry : CurrentTypes)
+	{
+		if (DependedOn.Contains(Entry.Key))
+		{
+			Contents += FString::Printf(TEXT("%s\t%s\t%s\n"), DocGenManifest::TypeEntry, *Entry.Key, *Entry.Value);
+		}
+	}
+
+	// Write alongside and swap in, so an interrupted save never leaves a truncated manifest
+	FString const TempFile = ManifestFile + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(Contents, *TempFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM) ||
+		!IFileManager::Get().Move(*ManifestFile, *TempFile, true, true))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save manifest %s"), *ManifestFile);
+		return false;
+	}
+	return SavePackages();
+}
+
+bool FDocGenManifest::IsNodeUnchanged(FString const& NodeKey, FString const& Hash) const
+{
+	FScopeLock Lock(&CS);
+	FString const* PreviousHash = PreviousNodes.Find(NodeKey);
+	return PreviousHash && *PreviousHash == Hash;
+}
+
+void FDocGenManifest::RecordNode(FString const& NodeKey, FString const& Hash)
+{
+	FScopeLock Lock(&CS);
+	CurrentNodes.Add(NodeKey, Hash);
+}
+
+bool FDocGenManifest::IsClassUnchanged(FString const& ClassId, FString const& Hash) const
+{
+	FScopeLock Lock(&CS);
+	FString const* PreviousHash = PreviousClasses.Find(ClassId);
+	return PreviousHash && *PreviousHash == Hash;
+}
+
+void FDocGenManifest::RecordClass(FString const& ClassId, FString const& Hash)
+{
+	FScopeLock Lock(&CS);
+	CurrentClasses.Add(ClassId, Hash);
+}
+
+TArray<FString> FDocGenManifest::GetPreviousNodeKeys() const
+{
+	FScopeLock Lock(&CS);
+	TArray<FString> Keys;
+	PreviousNodes.GenerateKeyArray(Keys);
+	return Keys;
+}
+
+TArray<FString> FDocGenManifest::GetPreviousClassIds() const
+{
+	FScopeLock Lock(&CS);
+	TArray<FString> Keys;
+	PreviousClasses.GenerateKeyArray(Keys);
+	return Keys;
+}
+
+bool FDocGenManifest::IsPackageUnchanged(FName PackageName, FString const& Signature) const
+{
+	FScopeLock Lock(&CS);
+	FPackageEntry const* Entry = PreviousPackages.Find(PackageName);
+	return Entry && Entry->Signature == Signature;
+}
+
+void FDocGenManifest::CarryPackageForward(FName PackageName, TArray<FNodeDocsGenerator::FDocumentedNode>& OutNodes,
+										  TArray<FNodeDocsGenerator::FTypeSnapshot>& OutTypes)
+{
+	FScopeLock Lock(&CS);
+	FPackageEntry const* Entry = PreviousPackages.Find(PackageName);
+	if (Entry == nullptr)
+	{
+		return;
+	}
+
+	CurrentPackages.Add(PackageName, *Entry).bCarried = true;
+	for (auto const& Node : Entry->Nodes)
+	{
+		FString const NodeKey = FNodeDocsGenerator::MakeNodeKey(Node.ClassId, Node.NodeId);
+		if (FString const* Hash = PreviousNodes.Find(NodeKey))
+		{
+			CurrentNodes.Add(NodeKey, *Hash);
+		}
+		if (TArray<FString> const* TypePaths = PreviousDependencies.Find(NodeKey))
+		{
+			CurrentDependencies.Add(NodeKey, *TypePaths);
+		}
+	}
+	OutNodes.Append(Entry->Nodes);
+	OutTypes.Append(Entry->Types);
+}
+
+void FDocGenManifest::BeginPackage(FName PackageName, FString const& Signature, int32 NumObjects)
+{
+	FScopeLock Lock(&CS);
+	FPackageEntry& Entry = CurrentPackages.Add(PackageName);
+	Entry.Signature = Signature;
+	Entry.PendingObjects = NumObjects;
+	Entry.bComplete = NumObjects <= 0;
+}
+
+void FDocGenManifest::RecordPackageNode(FString const& ObjectPath, FNodeDocsGenerator::FDocumentedNode const& Node)
+{
+	FScopeLock Lock(&CS);
+	if (FPackageEntry* Entry = FindCurrentPackage(ObjectPath))
+	{
+		// The body is already on disk, and may be large
+		FNodeDocsGenerator::FDocumentedNode& Recorded = Entry->Nodes.Add_GetRef(Node);
+		Recorded.NodeDocBody.Reset();
+	}
+}
+
+void FDocGenManifest::RecordPackageType(FString const& ObjectPath, FNodeDocsGenerator::FTypeSnapshot const& Type)
+{
+	FScopeLock Lock(&CS);
+	if (FPackageEntry* Entry = FindCurrentPackage(ObjectPath))
+	{
+		Entry->Types.Add(Type);
+	}
+}
+
+void FDocGenManifest::EndPackage(FString const& ObjectPath)
+{
+	FScopeLock Lock(&CS);
+	if (FPackageEntry* Entry = FindCurrentPackage(ObjectPath))
+	{
+		Entry->bComplete = --Entry->PendingObjects <= 0;
+	}
+}
+
+int32 FDocGenManifest::InvalidateDependents(TFunctionRef<FString(FString const&)> HashType)
+{
+	check(IsInGameThread());
+
+	FScopeLock Lock(&CS);
+	TArray<FString> Changed;
+	for (auto const& Entry : PreviousTypes)
+	{
+		FString const Hash = HashType(Entry.Key);
+		if (Hash != Entry.Value)
+		{
+			Changed.Add(Entry.Key);
+		}
+		if (!Hash.IsEmpty())
+		{
+			CurrentTypes.Add(Entry.Key, Hash);
+		}
+	}
+	if (Changed.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Walk the graph backwards from the changed types
+	TMultiMap<FString, FString> Dependents;
+	for (auto const& Entry : PreviousDependencies)
+	{
+		for (auto const& TypePath : Entry.Value)
+		{
+			Dependents.Add(TypePath, Entry.Key);
+		}
+	}
+	TSet<FString> Invalidated;
+	TArray<FString> Direct;
+	for (int32 Index = 0; Index < Changed.Num(); ++Index)
+	{
+		Direct.Reset();
+		Dependents.MultiFind(Changed[Index], Direct);
+		for (auto const& Dependent : Direct)
+		{
+			bool bAlreadyInvalidated = false;
+			Invalidated.Add(Dependent, &bAlreadyInvalidated);
+			if (!bAlreadyInvalidated)
+			{
+				Changed.Add(Dependent);
+			}
+		}
+	}
+
+	int32 NumInvalidated = 0;
+	for (auto const& Key : Invalidated)
+	{
+		NumInvalidated += PreviousNodes.Remove(Key);
+	}
+	// A package is only carried forward whole, so any invalidated node means loading it again
+	for (auto It = PreviousPackages.CreateIterator(); It; ++It)
+	{
+		for (auto const& Node : It->Value.Nodes)
+		{
+			if (Invalidated.Contains(FNodeDocsGenerator::MakeNodeKey(Node.ClassId, Node.NodeId)))
+			{
+				It.RemoveCurrent();
+				break;
+			}
+		}
+	}
+	return NumInvalidated;
+}
+
+bool FDocGenManifest::HasType(FString const& TypePath) const
+{
+	FScopeLock Lock(&CS);
+	return CurrentTypes.Contains(TypePath);
+}
+
+void FDocGenManifest::RecordType(FString const& TypePath, FString const& Hash)
+{
+	FScopeLock Lock(&CS);
+	CurrentTypes.Add(TypePath, Hash);
+}
+
+void FDocGenManifest::RecordDependencies(FString const& NodeKey, TArray<FString> const& TypePaths)
+{
+	FScopeLock Lock(&CS);
+	CurrentDependencies.Add(NodeKey, TypePaths);
+}
+
+FDocGenManifest::FPackageEntry* FDocGenManifest::FindCurrentPackage(FString const& ObjectPath)
+{
+	FPackageEntry* Entry = CurrentPackages.Find(FName(*FPackageName::ObjectPathToPackageName(ObjectPath)));
+	return Entry && !Entry->bCarried ? Entry : nullptr;
+}
+
+bool FDocGenManifest::LoadPackages()
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*PackagesFile));
+	if (!Reader.IsValid())
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	FString Version;
+	FString Signature;
+	*Reader << Magic << Version << Signature;
+	if (Reader->IsError() || Magic != DocGenManifest::PackagesMagic || Version != DocGenManifest::Version ||
+		Signature != SettingsSignature)
+	{
+		return false;
+	}
+
+	int32 NumPackages = 0;
+	*Reader << NumPackages;
+	for (int32 Index = 0; Index < NumPackages && !Reader->IsError(); ++Index)
+	{
+		FString PackageName;
+		FPackageEntry Entry;
+		*Reader << PackageName << Entry.Signature;
+		DocGenManifest::SerializeArray(*Reader, Entry.Nodes, &DocGenManifest::SerializeNode);
+		DocGenManifest::SerializeArray(*Reader, Entry.Types, &DocGenManifest::SerializeType);
+		Entry.bComplete = true;
+		PreviousPackages.Add(FName(*PackageName), MoveTemp(Entry));
+	}
+	return !Reader->IsError();
+}
+
+bool FDocGenManifest::SavePackages() const
+{
+	FString const TempFile = PackagesFile + TEXT(".tmp");
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFile));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save manifest %s"), *PackagesFile);
+		return false;
+	}
+
+	uint32 Magic = DocGenManifest::PackagesMagic;
+	FString Version = DocGenManifest::Version;
+	FString Signature = SettingsSignature;
+	*Writer << Magic << Version << Signature;
+
+	// Packages whose documentation was interrupted are left out, so they are loaded again next time
+	int32 NumPackages = 0;
+	for (auto const& Pair : CurrentPackages)
+	{
+		NumPackages += Pair.Value.bComplete ? 1 : 0;
+	}
+	*Writer << NumPackages;
+	for (auto const& Pair : CurrentPackages)
+	{
+		if (Pair.Value.bComplete)
+		{
+			FString PackageName = Pair.Key.ToString();
+			FPackageEntry Entry = Pair.Value;
+			*Writer << PackageName << Entry.Signature;
+			DocGenManifest::SerializeArray(*Writer, Entry.Nodes, &DocGenManifest::SerializeNode);
+			DocGenManifest::SerializeArray(*Writer, Entry.Types, &DocGenManifest::SerializeType);
+		}
+	}
+
+	bool const bWritten = Writer->Close() && !Writer->IsError();
+	Writer.Reset();
+	if (!bWritten || !IFileManager::Get().Move(*PackagesFile, *TempFile, true, true))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save manifest %s"), *PackagesFile);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,107 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "NodeDocsGenerator.h"
+
+/*
+Content hashes of the nodes and class docs generated by the last run, kept in the intermediate directory so that an
+incremental run only regenerates what has changed.
+Hashes from the previous run are read by Load; those of the current run are recorded as it goes and written by Save
+once the run has succeeded, so a failed run never leaves a manifest describing files it didn't write.
+It also keeps, for each content package, its asset registry signature and everything documented from it, so that an
+incremental run can carry an unchanged package forward without loading it.
+Docs that show reflected types they don't own, such as node pins showing structs and enums, are recorded against those
+types along with a hash of each type. An incremental run invalidates whatever depends on a type that has changed.
+*/
+class FDocGenManifest
+{
+public:
+	FDocGenManifest(FString const& InIntermediateDir, FString const& InSettingsSignature);
+
+	/** Reads the manifest of the previous run. Returns false if there isn't one made with the same settings. */
+	bool Load();
+	/** Replaces the manifest on disk with the hashes recorded during this run */
+	bool Save() const;
+
+	/** Callable from any thread */
+	bool IsNodeUnchanged(FString const& NodeKey, FString const& Hash) const;
+	void RecordNode(FString const& NodeKey, FString const& Hash);
+	bool IsClassUnchanged(FString const& ClassId, FString const& Hash) const;
+	void RecordClass(FString const& ClassId, FString const& Hash);
+
+	/** Entries of the previous run, to find the files left by nodes and classes that no longer exist */
+	TArray<FString> GetPreviousNodeKeys() const;
+	TArray<FString> GetPreviousClassIds() const;
+
+	/** Whether the last run fully documented the package, as it was saved then */
+	bool IsPackageUnchanged(FName PackageName, FString const& Signature) const;
+	/** Keeps a package's entries from the last run, returning the nodes and types documented from it */
+	void CarryPackageForward(FName PackageName, TArray<FNodeDocsGenerator::FDocumentedNode>& OutNodes,
+							 TArray<FNodeDocsGenerator::FTypeSnapshot>& OutTypes);
+	/**
+	 * Starts collecting what is documented from a package. It is only kept once EndPackage has been reached for each of
+	 * the package's NumObjects objects, so the nodes of each object must be recorded before the object ends.
+	 */
+	void BeginPackage(FName PackageName, FString const& Signature, int32 NumObjects = 1);
+	/** Objects outside any begun package are ignored */
+	void RecordPackageNode(FString const& ObjectPath, FNodeDocsGenerator::FDocumentedNode const& Node);
+	void RecordPackageType(FString const& ObjectPath, FNodeDocsGenerator::FTypeSnapshot const& Type);
+	void EndPackage(FString const& ObjectPath);
+
+	/**
+	 * Game thread only, before anything is documented. Hashes every type the last run's docs depend on with
+	 * HashType, which returns an empty hash for types that no longer exist. The nodes that depend on a changed type,
+	 * and the packages they were documented from, are forgotten so that they are regenerated. Returns the number of
+	 * nodes invalidated.
+	 */
+	int32 InvalidateDependents(TFunctionRef<FString(FString const&)> HashType);
+	bool HasType(FString const& TypePath) const;
+	void RecordType(FString const& TypePath, FString const& Hash);
+	/** Records the types a node's doc shows, keyed as for RecordNode */
+	void RecordDependencies(FString const& NodeKey, TArray<FString> const& TypePaths);
+
+protected:
+	struct FPackageEntry
+	{
+		FString Signature;
+		bool bComplete = false;
+		// Objects yet to end this run. Not saved.
+		int32 PendingObjects = 0;
+		// Copied from the last run, so anything documented from the package again (as a priority class) is dropped
+		bool bCarried = false;
+		TArray<FNodeDocsGenerator::FDocumentedNode> Nodes;
+		TArray<FNodeDocsGenerator::FTypeSnapshot> Types;
+	};
+
+	// Caller must hold CS
+	bool LoadPackages();
+	bool SavePackages() const;
+	// Null unless the package was begun this run
+	FPackageEntry* FindCurrentPackage(FString const& ObjectPath);
+
+protected:
+	FString ManifestFile;
+	// Package entries hold free text, so they are kept in a binary file alongside
+	FString PackagesFile;
+	FString SettingsSignature;
+
+	mutable FCriticalSection CS;
+	TMap<FString, FString> PreviousNodes;
+	TMap<FString, FString> PreviousClasses;
+	TMap<FString, FString> CurrentNodes;
+	TMap<FString, FString> CurrentClasses;
+	TMap<FName, FPackageEntry> PreviousPackages;
+	TMap<FName, FPackageEntry> CurrentPackages;
+	// Type hashes by path, and the types each node depends on
+	TMap<FString, FString> PreviousTypes;
+	TMap<FString, FString> CurrentTypes;
+	TMap<FString, TArray<FString>> PreviousDependencies;
+	TMap<FString, TArray<FString>> CurrentDependencies;
+};
@@ -0,0 +1,330 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Queue.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+/*
+FIFO connecting two stages of the doc gen pipeline, with a high-water mark rather than a hard bound.
+Producers and consumers run as tasks, which mustn't block, so nothing waits on the queue. Instead a producer asks
+WhenNotFull before producing more, and overshoots the mark by at most what it pushes at once, which is enough to stop
+a producer running arbitrarily far ahead of its consumers. Occupancy and wait times are recorded so the bottleneck
+stage can be identified after a run.
+*/
+template <typename T>
+class TDocGenStageQueue
+{
+public:
+	TDocGenStageQueue(FString const& InName, int32 InCapacity)
+		: Name(InName)
+		, Capacity(FMath::Max(1, InCapacity))
+	{}
+
+	/** Queues the item however full the queue is. Returns false, dropping the item, if the queue was closed. */
+	bool PushNoWait(T&& Item)
+	{
+		FScopeLock Lock(&CS);
+		if (bClosed)
+		{
+			return false;
+		}
+		Items.Enqueue(MoveTemp(Item));
+		++Num;
+		++TotalPushed;
+		OccupancySum += Num;
+		PeakOccupancy = FMath::Max(PeakOccupancy, Num);
+		return true;
+	}
+
+	/**
+	 * Runs Callback once the queue is below its high-water mark, or closed: straight away if it already is, otherwise
+	 * on the thread whose TryPop makes room. Callback should do no more than queue further work.
+	 */
+	void WhenNotFull(TFunction<void()> Callback)
+	{
+		{
+			FScopeLock Lock(&CS);
+			if (!bClosed && Num >= Capacity)
+			{
+				NotFullWaiters.Add({MoveTemp(Callback), FPlatformTime::Seconds()});
+				return;
+			}
+		}
+		Callback();
+	}
+
+	/** Takes the next item if there is one */
+	bool TryPop(T& OutItem)
+	{
+		TArray<FNotFullWaiter> Ready;
+		{
+			FScopeLock Lock(&CS);
+			if (!Items.Dequeue(OutItem))
+			{
+				return false;
+			}
+			--Num;
+			if (Num < Capacity)
+			{
+				Ready = TakeNotFullWaiters();
+			}
+		}
+		RunNotFullWaiters(Ready);
+		return true;
+	}
+
+	bool IsFull() const
+	{
+		FScopeLock Lock(&CS);
+		return !bClosed && Num >= Capacity;
+	}
+
+	bool IsEmpty() const
+	{
+		FScopeLock Lock(&CS);
+		return Num == 0;
+	}
+
+	/** Signals that no more items will be pushed. Consumers drain whatever is left. */
+	void Close()
+	{
+		TArray<FNotFullWaiter> Ready;
+		{
+			FScopeLock Lock(&CS);
+			bClosed = true;
+			Ready = TakeNotFullWaiters();
+		}
+		RunNotFullWaiters(Ready);
+	}
+
+	/** Closes the queue and discards anything not yet consumed. */
+	void Abort()
+	{
+		TArray<FNotFullWaiter> Ready;
+		{
+			FScopeLock Lock(&CS);
+			bClosed = true;
+			Items.Empty();
+			Num = 0;
+			Ready = TakeNotFullWaiters();
+		}
+		RunNotFullWaiters(Ready);
+	}
+
+	FString DescribeStats() const
+	{
+		FScopeLock Lock(&CS);
+		return FString::Printf(TEXT("%s queue: %d items, peak %d/%d, mean occupancy %.1f, producer held back %.2fs"),
+							   *Name, TotalPushed, PeakOccupancy, Capacity,
+							   TotalPushed > 0 ? (double) OccupancySum / TotalPushed : 0.0, ProducerHeldSeconds);
+	}
+
+private:
+	struct FNotFullWaiter
+	{
+		TFunction<void()> Callback;
+		double WaitStart;
+	};
+
+	// Caller must hold CS
+	TArray<FNotFullWaiter> TakeNotFullWaiters()
+	{
+		double const Now = FPlatformTime::Seconds();
+		for (auto const& Waiter : NotFullWaiters)
+		{
+			ProducerHeldSeconds += Now - Waiter.WaitStart;
+		}
+		return MoveTemp(NotFullWaiters);
+	}
+
+	// Outside the lock, since a callback may push to this queue
+	static void RunNotFullWaiters(TArray<FNotFullWaiter>& Ready)
+	{
+		for (auto& Waiter : Ready)
+		{
+			Waiter.Callback();
+		}
+	}
+
+	FString Name;
+	int32 Capacity;
+
+	mutable FCriticalSection CS;
+	TQueue<T> Items;
+	int32 Num = 0;
+	bool bClosed = false;
+	TArray<FNotFullWaiter> NotFullWaiters;
+
+	// Stats
+	int32 TotalPushed = 0;
+	int32 PeakOccupancy = 0;
+	int64 OccupancySum = 0;
+	double ProducerHeldSeconds = 0.0;
+};
+
+/*
+Runs the consumers of a pipeline stage as task graph tasks, rather than on threads of their own for the whole run.
+Kick starts a task whenever there may be work and fewer than the maximum are running; each task calls DrainOne until
+it finds nothing to do and then ends, so a stage that is idle or held up by the next one holds no thread.
+*/
+class FDocGenStageWorkers
+{
+public:
+	/** DrainOne processes a single item, returning false if there was nothing it could process */
+	FDocGenStageWorkers(FString const& InName, int32 InMaxWorkers, TFunction<bool()> InDrainOne)
+		: Name(InName)
+		, MaxWorkers(FMath::Max(1, InMaxWorkers))
+		, DrainOne(MoveTemp(InDrainOne))
+	{}
+
+	~FDocGenStageWorkers()
+	{
+		check(IsIdle());
+	}
+
+	/** Callable from any thread, once there is work to do */
+	void Kick()
+	{
+		FScopeLock Lock(&CS);
+		if (Running >= MaxWorkers)
+		{
+			// A running task picks the work up before it ends
+			bKicked = true;
+			return;
+		}
+		++Running;
+		++TasksStarted;
+		PeakRunning = FMath::Max(PeakRunning, Running);
+		Tasks.RemoveAll([](FGraphEventRef const& Task) { return Task->IsComplete(); });
+		Tasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this] { Run(); }, TStatId(), nullptr,
+																  ENamedThreads::AnyBackgroundThreadNormalTask));
+	}
+
+	/**
+	 * Keeps the stage from counting as idle until the returned hold is passed to Release, for work that has left the
+	 * stage but will come back to it. Callable from any thread.
+	 */
+	FGraphEventRef Hold()
+	{
+		FGraphEventRef HoldEvent = FGraphEvent::CreateGraphEvent();
+		FScopeLock Lock(&CS);
+		Tasks.Add(HoldEvent);
+		return HoldEvent;
+	}
+
+	/** Should be the last thing the holder does with the stage, since a waiter may then move on and destroy it */
+	static void Release(FGraphEventRef const& HoldEvent)
+	{
+		HoldEvent->DispatchSubsequents();
+	}
+
+	/** True if no task is running or hold held. Work may still be queued, if the stage is held up by the next one. */
+	bool IsIdle() const
+	{
+		FScopeLock Lock(&CS);
+		for (auto const& Task : Tasks)
+		{
+			if (!Task->IsComplete())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Waits for the tasks running and holds held now, and any they start. Not callable from a task graph worker. */
+	void WaitUntilIdle()
+	{
+		while (true)
+		{
+			FGraphEventArray Pending;
+			{
+				FScopeLock Lock(&CS);
+				Tasks.RemoveAll([](FGraphEventRef const& Task) { return Task->IsComplete(); });
+				Pending = Tasks;
+			}
+			if (Pending.Num() == 0)
+			{
+				return;
+			}
+			FTaskGraphInterface::Get().WaitUntilTasksComplete(Pending);
+		}
+	}
+
+	FString DescribeStats() const
+	{
+		FScopeLock Lock(&CS);
+		return FString::Printf(TEXT("%s workers: %d tasks, peak %d/%d running"), *Name, TasksStarted, PeakRunning,
+							   MaxWorkers);
+	}
+
+private:
+	void Run()
+	{
+		while (true)
+		{
+			while (DrainOne())
+			{
+			}
+			FScopeLock Lock(&CS);
+			if (!bKicked)
+			{
+				--Running;
+				return;
+			}
+			bKicked = false;
+		}
+	}
+
+	FString Name;
+	int32 MaxWorkers;
+	TFunction<bool()> DrainOne;
+
+	mutable FCriticalSection CS;
+	// Running tasks and outstanding holds. Completion is only signalled once a task has returned, so waiting on
+	// these is safe ahead of destruction.
+	FGraphEventArray Tasks;
+	int32 Running = 0;
+	bool bKicked = false;
+
+	// Stats
+	int32 TasksStarted = 0;
+	int32 PeakRunning = 0;
+};
+
+/*
+Accumulates the time a pipeline stage spends doing work, from any number of threads.
+*/
+class FDocGenStageTimer
+{
+public:
+	explicit FDocGenStageTimer(FString const& InName) : Name(InName) {}
+
+	void Add(double Seconds, int32 Items = 1)
+	{
+		FScopeLock Lock(&CS);
+		BusySeconds += Seconds;
+		ItemCount += Items;
+	}
+
+	FString DescribeStats() const
+	{
+		FScopeLock Lock(&CS);
+		return FString::Printf(TEXT("%s stage: %d items, %.2fs busy"), *Name, ItemCount, BusySeconds);
+	}
+
+private:
+	FString Name;
+	mutable FCriticalSection CS;
+	double BusySeconds = 0.0;
+	int32 ItemCount = 0;
+};
@@ -33,6 +33,36 @@ void UKantanDocGenSettingsObject::InitDefaults(UKantanDocGenSettingsObject* CDO)
 	{
 		CDO->Settings.BlueprintContextClass = AActor::StaticClass();
 	}
+
+	if (CDO->Settings.NodeSpawnBatchSize <= 0)
+	{
+		CDO->Settings.NodeSpawnBatchSize = 1;
+	}
+
+	if (CDO->Settings.PipelineQueueCapacity <= 0)
+	{
+		CDO->Settings.PipelineQueueCapacity = 1;
+	}
+
+	if (CDO->Settings.GameThreadBatchesInFlight <= 0)
+	{
+		CDO->Settings.GameThreadBatchesInFlight = 1;
+	}
+
+	if (CDO->Settings.GameThreadBudgetMs < 0.0f)
+	{
+		CDO->Settings.GameThreadBudgetMs = 0.0f;
+	}
+
+	if (CDO->Settings.ImageCacheSizeMB < 0)
+	{
+		CDO->Settings.ImageCacheSizeMB = 0;
+	}
+
+	if (CDO->WatchDelaySeconds < 0.0f)
+	{
+		CDO->WatchDelaySeconds = 0.0f;
+	}
 }
 
 void UKantanDocGenSettingsObject::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
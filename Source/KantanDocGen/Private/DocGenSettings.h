@@ -44,6 +44,13 @@ public:
 	UPROPERTY() // EditAnywhere, Category = "Class Search")
 	TArray<FName> SpecificClasses;
 
+	/**
+	 * Names of classes/blueprints to document before anything else. Each one's class doc is written as soon as its
+	 * nodes are done, rather than when the whole run completes.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Class Search", AdvancedDisplay)
+	TArray<FName> PriorityClasses;
+
 	/** Names of specific classes/blueprints to exclude. */
 	UPROPERTY() // EditAnywhere, Category = "Class Search")
 	TArray<FName> ExcludedClasses;
@@ -63,11 +70,64 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Output")
 	bool bCleanOutputDirectory;
 
+	/**
+	 * Carry on from the checkpoint left by an interrupted run with the same settings, rather than starting over. Off
+	 * by default, so an ordinary run never picks up a stale checkpoint.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bResumeFromCheckpoint;
+
+	/** Keep the intermediate docs of the last run with the same settings, and only regenerate what has changed. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bIncremental;
+
+	/** Maximum number of nodes spawned in a single round trip to the game thread. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "1"))
+	int32 NodeSpawnBatchSize;
+
+	/** Most tasks generating node doc trees in parallel. 0 uses one per task graph worker thread. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "0"))
+	int32 DocTreeWorkerThreads;
+
+	/** Most tasks encoding and writing node images in parallel. 0 uses one per task graph worker thread. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "0"))
+	int32 ImageEncodeWorkerThreads;
+
+	/** Maximum number of nodes held between each pair of pipeline stages. Caps memory used by rendered images. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "1"))
+	int32 PipelineQueueCapacity;
+
+	/** Number of spawn and render steps queued on the game thread at once, so it never waits on the background stages. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "1"))
+	int32 GameThreadBatchesInFlight;
+
+	/** Game thread time doc gen may use per frame, in milliseconds. Batches are sized to fit. 0 removes the limit. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "0"))
+	float GameThreadBudgetMs;
+
+	/** Megabytes of rendered node images kept between runs, so unchanged nodes aren't rendered again. 0 disables it. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay, Meta = (ClampMin = "0"))
+	int32 ImageCacheSizeMB;
+
+	/** Share node images and doc trees through the derived data cache, for reuse across projects and machines. */
+	UPROPERTY(EditAnywhere, Category = "Performance", AdvancedDisplay)
+	bool bUseDerivedDataCache;
+
 public:
 	FKantanDocGenSettings()
 	{
 		BlueprintContextClass = AActor::StaticClass();
 		bCleanOutputDirectory = false;
+		bResumeFromCheckpoint = false;
+		bIncremental = false;
+		NodeSpawnBatchSize = 32;
+		DocTreeWorkerThreads = 0;
+		ImageEncodeWorkerThreads = 0;
+		PipelineQueueCapacity = 64;
+		GameThreadBatchesInFlight = 2;
+		GameThreadBudgetMs = 4.0f;
+		ImageCacheSizeMB = 256;
+		bUseDerivedDataCache = true;
 	}
 
 	bool HasAnySources() const
@@ -92,4 +152,17 @@ public:
 public:
 	UPROPERTY(EditAnywhere, Export, config, Category = "Kantan DocGen", Meta = (ShowOnlyInnerProperties))
 	FKantanDocGenSettings Settings;
+
+	/**
+	 * Regenerate the docs incrementally whenever code is reloaded or a blueprint being documented is saved. Content
+	 * packages and native modules unchanged since the last run are carried forward without being walked, so a run
+	 * only spawns the nodes of what was saved or reloaded.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Watch Mode")
+	bool bWatchForChanges = false;
+
+	/** Seconds to wait after the last change before regenerating, so that a burst of saves only triggers one run. */
+	UPROPERTY(EditAnywhere, config, Category = "Watch Mode",
+			  Meta = (ClampMin = "0", EditCondition = "bWatchForChanges"))
+	float WatchDelaySeconds = 2.0f;
 };
@@ -0,0 +1,55 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenSharedNodeCache.h"
+#include "BlueprintNodeSpawner.h"
+#include "DocTreeNode.h"
+#include "Misc/ScopeLock.h"
+
+FDocGenSharedNodeCache::FClaim::FClaim() : bFulfilled(false) {}
+
+FDocGenSharedNodeCache::FClaim::~FClaim()
+{
+	if (!bFulfilled)
+	{
+		Promise.SetValue(FSharedNode());
+	}
+}
+
+void FDocGenSharedNodeCache::FClaim::Fulfil(FNodeDocsGenerator::FDocumentedNode const& Node)
+{
+	check(!bFulfilled);
+	bFulfilled = true;
+
+	// The doc tree is still referenced by the claiming task, so hand out an independent copy of it
+	auto Shared = MakeShared<FNodeDocsGenerator::FDocumentedNode, ESPMode::ThreadSafe>(Node);
+	Shared->NodeDocBody = Node.NodeDocBody.IsValid() ? Node.NodeDocBody->Clone() : nullptr;
+	Promise.SetValue(Shared);
+}
+
+TSharedPtr<FDocGenSharedNodeCache::FClaim, ESPMode::ThreadSafe> FDocGenSharedNodeCache::Claim(
+	UBlueprintNodeSpawner* Spawner, UObject* SourceObject, FSharedNodeFuture& OutResult)
+{
+	FKey const Key(FObjectKey(Spawner), FObjectKey(SourceObject));
+
+	FScopeLock Lock(&CS);
+	if (FSharedNodeFuture* Existing = Results.Find(Key))
+	{
+		++NumShared;
+		OutResult = *Existing;
+		return nullptr;
+	}
+
+	auto NewClaim = MakeShared<FClaim, ESPMode::ThreadSafe>();
+	Results.Add(Key, NewClaim->Promise.GetFuture().Share());
+	return NewClaim;
+}
+
+int32 FDocGenSharedNodeCache::GetNumShared() const
+{
+	FScopeLock Lock(&CS);
+	return NumShared;
+}
@@ -0,0 +1,63 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "NodeDocsGenerator.h"
+#include "UObject/ObjectKey.h"
+
+class UBlueprintNodeSpawner;
+
+/*
+Lets doc tasks running side by side share the nodes they have in common.
+The first task to claim a spawner/source object pair spawns, renders and documents the node; every other task
+receives the finished result and only has to register it with its own output.
+*/
+class FDocGenSharedNodeCache
+{
+public:
+	using FSharedNode = TSharedPtr<const FNodeDocsGenerator::FDocumentedNode, ESPMode::ThreadSafe>;
+	using FSharedNodeFuture = TSharedFuture<FSharedNode>;
+
+	/*
+	Held by the task that claimed a node. Destroying an unfulfilled claim publishes an empty result, so that
+	tasks waiting on a node which failed or was dropped are never left hanging.
+	*/
+	class FClaim
+	{
+	public:
+		FClaim();
+		~FClaim();
+
+		void Fulfil(FNodeDocsGenerator::FDocumentedNode const& Node);
+
+	private:
+		friend class FDocGenSharedNodeCache;
+
+		TPromise<FSharedNode> Promise;
+		bool bFulfilled;
+	};
+
+public:
+	/**
+	 * Claims generation of the node for a spawner and source object pair.
+	 * @return A claim if the caller should generate the node, otherwise null with OutResult set to the future result.
+	 */
+	TSharedPtr<FClaim, ESPMode::ThreadSafe> Claim(UBlueprintNodeSpawner* Spawner, UObject* SourceObject,
+												  FSharedNodeFuture& OutResult);
+
+	int32 GetNumShared() const;
+
+private:
+	using FKey = TPair<FObjectKey, FObjectKey>;
+
+	mutable FCriticalSection CS;
+	TMap<FKey, FSharedNodeFuture> Results;
+	int32 NumShared = 0;
+};
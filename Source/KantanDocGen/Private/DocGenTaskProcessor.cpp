@@ -6,20 +6,27 @@
 
 #include "DocGenTaskProcessor.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Async/TaskGraphInterfaces.h"
-#include "BlueprintActionDatabase.h"
+#include "DocGenActionIndex.h"
 #include "BlueprintNodeSpawner.h"
+#include "DocGenGameThreadScheduler.h"
+#include "DocGenJournal.h"
+#include "DocGenPipeline.h"
 #include "Enumeration/CompositeEnumerator.h"
 #include "Enumeration/ContentPathEnumerator.h"
 #include "Enumeration/ISourceObjectEnumerator.h"
-#include "Enumeration/NativeModuleEnumerator.h"
+#include "Enumeration/PriorityClassEnumerator.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "HAL/FileManager.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Interfaces/IPluginManager.h"
 #include "K2Node.h"
 #include "KantanDocGenLog.h"
 #include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 #include "NodeDocsGenerator.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
@@ -32,11 +39,13 @@ FDocGenTaskProcessor::FDocGenTaskProcessor()
 {
 	bRunning = false;
 	bTerminationRequest = false;
+	Scheduler = MakeUnique<FDocGenGameThreadScheduler>();
 }
 
 void FDocGenTaskProcessor::QueueTask(FKantanDocGenSettings const& Settings)
 {
-	TSharedPtr<FDocGenTask> NewTask = MakeShared<FDocGenTask>();
+	TSharedPtr<FDocGenTask> NewTask =
+		MakeShared<FDocGenTask>(FSimpleDelegate::CreateRaw(this, &FDocGenTaskProcessor::Stop));
 	NewTask->Settings = Settings;
 	NewTask->NotifySetCompletionState(SNotificationItem::CS_Pending);
 	Waiting.Enqueue(NewTask);
@@ -47,6 +56,11 @@ bool FDocGenTaskProcessor::IsRunning() const
 	return bRunning;
 }
 
+bool FDocGenTaskProcessor::TryStartRunning()
+{
+	return !bRunning.AtomicSet(true);
+}
+
 bool FDocGenTaskProcessor::Init()
 {
 	bRunning = true;
@@ -55,11 +69,55 @@ bool FDocGenTaskProcessor::Init()
 
 uint32 FDocGenTaskProcessor::Run()
 {
+	TArray<TSharedPtr<FDocGenTask>> Group;
 	TSharedPtr<FDocGenTask> Next;
-	while (!bTerminationRequest && Waiting.Dequeue(Next))
+	do
 	{
-		ProcessTask(Next);
-	}
+		while (!bTerminationRequest && Waiting.Dequeue(Next))
+		{
+			// Gather whatever else is already queued so it can run alongside. Tasks writing to the same intermediate
+			// directory have to wait for the next group.
+			Group.Reset();
+			Group.Add(Next);
+			TSharedPtr<FDocGenTask>* Peeked = nullptr;
+			while ((Peeked = Waiting.Peek()) != nullptr)
+			{
+				FString const& Title = (*Peeked)->Settings.DocumentationTitle;
+				if (Group.ContainsByPredicate([&Title](TSharedPtr<FDocGenTask> const& Task) {
+						return Task->Settings.DocumentationTitle == Title;
+					}))
+				{
+					break;
+				}
+				Group.Add(*Peeked);
+				Waiting.Pop();
+			}
+
+			ProcessTaskGroup(Group);
+
+			if (bTerminationRequest)
+			{
+				for (auto const& Task : Group)
+				{
+					NotifyCancelled(Task);
+				}
+			}
+		}
+
+		if (bTerminationRequest)
+		{
+			// Anything still queued is cancelled along with the tasks that were running
+			while (Waiting.Dequeue(Next))
+			{
+				NotifyCancelled(Next);
+			}
+			UE_LOG(LogKantanDocGen, Display, TEXT("Doc gen cancelled"));
+			bTerminationRequest = false;
+		}
+
+		bRunning = false;
+		// A task queued after the queue was found empty would otherwise wait for a run that never starts
+	} while (!Waiting.IsEmpty() && TryStartRunning());
 
 	return 0;
 }
@@ -72,16 +130,87 @@ void FDocGenTaskProcessor::Exit()
 void FDocGenTaskProcessor::Stop()
 {
 	bTerminationRequest = true;
+
+	FScopeLock Lock(&ActiveOutputProcessorsLock);
+	for (auto const& OutputProcessor : ActiveOutputProcessors)
+	{
+		OutputProcessor->Cancel();
+	}
+}
+
+void FDocGenTaskProcessor::NotifyCancelled(TSharedPtr<FDocGenTask> Task)
+{
+	Async(EAsyncExecution::TaskGraphMainThread, [Task] {
+		Task->NotifySetText(LOCTEXT("DocGenCancelled", "Doc gen cancelled"));
+		Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
+		Task->NotifyExpireFadeOut();
+	});
 }
 
-void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
+void FDocGenTaskProcessor::ProcessTaskGroup(TArray<TSharedPtr<FDocGenTask>> const& Group)
 {
-	Current = MakeShared<FDocGenCurrentTask>();
+	// Node images don't depend on the documentation set, so every task shares the one cache, sized to the largest
+	// The game thread budget is shared too, so the tightest one applies. A budget of 0 is no limit.
+	int32 ImageCacheSizeMB = 0;
+	bool bUseDerivedData = false;
+	float GameThreadBudgetMs = 0.0f;
+	for (auto const& Task : Group)
+	{
+		ImageCacheSizeMB = FMath::Max(ImageCacheSizeMB, Task->Settings.ImageCacheSizeMB);
+		bUseDerivedData |= Task->Settings.bUseDerivedDataCache;
+		float const TaskBudgetMs = Task->Settings.GameThreadBudgetMs;
+		if (TaskBudgetMs > 0.0f && (GameThreadBudgetMs <= 0.0f || TaskBudgetMs < GameThreadBudgetMs))
+		{
+			GameThreadBudgetMs = TaskBudgetMs;
+		}
+	}
+	Scheduler->SetFrameBudget(GameThreadBudgetMs / 1000.0);
+	if (ImageCacheSizeMB > 0)
+	{
+		if (!ImageCache.IsValid())
+		{
+			ImageCache = MakeUnique<FDocGenImageCache>(
+				FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir() / TEXT("KantanDocGenImageCache")));
+		}
+		ImageCache->SetMaxSize((int64) ImageCacheSizeMB * 1024 * 1024);
+		ImageCache->ResetStats();
+	}
+	if (bUseDerivedData && !DerivedData.IsValid())
+	{
+		DerivedData = MakeUnique<FDocGenDerivedData>();
+	}
+
+	if (Group.Num() == 1)
+	{
+		ProcessTask(Group[0], nullptr);
+		return;
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("Running %d doc gen tasks concurrently"), Group.Num());
+
+	// Every task still walks its own enumerators, but a node common to several tasks is only generated once
+	auto SharedNodes = MakeShared<FDocGenSharedNodeCache>();
+	TArray<TFuture<void>> Tasks;
+	for (auto const& Task : Group)
+	{
+		Tasks.Add(Async(EAsyncExecution::Thread, [this, Task, SharedNodes] { ProcessTask(Task, SharedNodes); }));
+	}
+	for (auto& Task : Tasks)
+	{
+		Task.Wait();
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("%d nodes were shared between concurrent doc gen tasks"),
+		   SharedNodes->GetNumShared());
+}
+
+void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask, TSharedPtr<FDocGenSharedNodeCache> SharedNodes)
+{
+	TSharedPtr<FDocGenCurrentTask> Current = MakeShared<FDocGenCurrentTask>();
 	Current->Task = InTask;
 	/********** Lambdas for the game thread to execute **********/
 
-	auto GameThread_InitDocGen = [Current = this->Current](FString const& DocTitle,
-														   FString const& IntermediateDir) -> bool {
+	auto GameThread_InitDocGen = [Current](FString const& DocTitle, FString const& IntermediateDir) -> bool {
 		if (!IsRunningCommandlet())
 		{
 			Current->Task->NotifyExpireDuration(2.0f);
@@ -91,22 +220,42 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return Current->DocGen->GT_Init(DocTitle, IntermediateDir, Current->Task->Settings.BlueprintContextClass);
 	};
 
-	TFunction<void()> GameThread_EnqueueEnumerators = [Current = this->Current]() {
-		// @TODO: Specific class enumerator
-		Current->Enumerators.Enqueue(
-			MakeShared<FCompositeEnumerator<FNativeModuleEnumerator>>(Current->Task->Settings.NativeModules));
-
+	TFunction<void()> GameThread_EnqueueEnumerators = [Current]() {
 		TArray<FName> ContentPackagePaths;
 		for (auto const& Path : Current->Task->Settings.ContentPaths)
 		{
 			ContentPackagePaths.AddUnique(FName(*Path.Path));
 		}
-		Current->Enumerators.Enqueue(MakeShared<FCompositeEnumerator<FContentPathEnumerator>>(ContentPackagePaths));
+
+		// Priority classes go first; they are skipped as already processed when the other enumerators reach them
+		if (Current->Task->Settings.PriorityClasses.Num() > 0)
+		{
+			Current->PriorityEnumerator = MakeShared<FPriorityClassEnumerator>(
+				Current->Task->Settings.PriorityClasses, Current->Task->Settings.NativeModules, ContentPackagePaths);
+			Current->AllEnumerators.Add(Current->PriorityEnumerator);
+		}
+
+		// @TODO: Specific class enumerator
+		Current->NativeEnumerator =
+			MakeShared<FCompositeEnumerator<FNativeModuleEnumerator>>(Current->Task->Settings.NativeModules);
+		Current->AllEnumerators.Add(Current->NativeEnumerator);
+
+		Current->ContentEnumerator = MakeShared<FCompositeEnumerator<FContentPathEnumerator>>(ContentPackagePaths);
+		Current->AllEnumerators.Add(Current->ContentEnumerator);
+
+		for (auto const& Enumerator : Current->AllEnumerators)
+		{
+			Current->Enumerators.Enqueue(Enumerator);
+		}
+
+		// Take the action database apart once up front, rather than looking up each object as it is enumerated.
+		// A commandlet has no other use for the database, so only populate it for what is being documented.
+		Current->ActionIndex.Build(Current->Task->Settings.NativeModules, ContentPackagePaths, IsRunningCommandlet());
 	};
 
-	auto GameThread_EnumerateNextObject = [this]() -> bool {
+	auto GameThread_EnumerateNextObject = [Current]() -> bool {
 		Current->SourceObject.Reset();
-		Current->CurrentSpawners.Empty();
+		Current->NextSpawner = Current->EndSpawner = 0;
 
 		while (auto Obj = Current->CurrentEnumerator->GetNext())
 		{
@@ -116,78 +265,124 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 			{
 				continue;
 			}
-			Current->SourceObject = Obj;
+			FString const ObjectPath = Obj->GetPathName();
 			Current->TypesToParseForMembers.Add(Obj);
-			// Cache list of spawners for this object
-			auto& BPActionMap = FBlueprintActionDatabase::Get().GetAllActions();
-			if (auto ActionList = BPActionMap.Find(Obj))
+			// Documented by an earlier, interrupted run
+			if (Current->Journal->IsObjectComplete(ObjectPath))
 			{
-				if (ActionList->Num() == 0)
-				{
-					continue;
-				}
+				Current->Processed.Add(Obj);
+				continue;
+			}
+			// Walk this object's bucket of spawners
+			FDocGenActionIndex::FBucket const Bucket = Current->ActionIndex.FindOrAddBucket(Obj);
+			if (Bucket.Num > 0)
+			{
+				Current->NextSpawner = Bucket.First;
+				Current->EndSpawner = Bucket.First + Bucket.Num;
 
-				for (auto Spawner : *ActionList)
+				// Done
+				if (Current->CurrentEnumerator == Current->PriorityEnumerator)
 				{
-					// Add to queue as weak ptr
-					check(Current->CurrentSpawners.Enqueue(Spawner));
+					FScopeLock Lock(&Current->PriorityClassDocsLock);
+					Current->PriorityClassDocs.Add(ObjectPath, FNodeDocsGenerator::GT_GetSourceClassDocId(Obj));
 				}
-
-				// Done
+				Current->SourceObject = Obj;
+				Current->SourceObjectPath = ObjectPath;
 				Current->Processed.Add(Obj);
+				Current->Journal->BeginObject(ObjectPath);
+				Current->Telemetry.AddObjects();
+				Current->Telemetry.UpdateProgress(Current->AllEnumerators);
 				return true;
 			}
+			// Nothing to spawn, so the object is done as soon as it is enumerated
+			Current->Manifest->EndPackage(ObjectPath);
 		}
 
 		// This enumerator is finished
 		return false;
 	};
 
-	auto GameThread_EnumerateNextNode = [this](FNodeDocsGenerator::FNodeProcessingState& OutState) -> UK2Node* {
+	auto GameThread_EnumerateNextNodeBatch = [this, Current, SharedNodes](TArray<FSpawnedNode>& OutBatch,
+																		 int32 MaxBatchSize) -> bool {
+		OutBatch.Reset();
+
 		// We've just come in from another thread, check the source object is still around
 		if (!Current->SourceObject.IsValid())
 		{
 			UE_LOG(LogKantanDocGen, Warning, TEXT("Object being enumerated expired!"));
-			return nullptr;
+			return false;
 		}
 
-		// Try to grab the next spawner in the cached list
-		TWeakObjectPtr<UBlueprintNodeSpawner> Spawner;
-		while (Current->CurrentSpawners.Dequeue(Spawner))
+		// Spawn nodes for as many of the object's spawners as the batch allows
+		while (!bTerminationRequest && OutBatch.Num() < MaxBatchSize && Current->NextSpawner < Current->EndSpawner)
 		{
-			if (Spawner.IsValid())
+			UBlueprintNodeSpawner* Spawner = Current->ActionIndex.GetSpawner(Current->NextSpawner++);
+			// Drop spawners that won't produce anything new before claiming, spawning or rendering them
+			if (Spawner && Current->DocGen->GT_ShouldSpawn(Spawner, Current->SourceObject.Get()))
 			{
-				// See if we can document this spawner
+				// See if we can document this spawner. Nodes already documented by this task, or which fail to spawn,
+				// are dropped here, before a claim is taken that would then publish an empty result.
+				FNodeDocsGenerator::FNodeProcessingState NodeState;
 				auto K2_NodeInst =
-					Current->DocGen->GT_InitializeForSpawner(Spawner.Get(), Current->SourceObject.Get(), OutState);
+					Current->DocGen->GT_InitializeForSpawner(Spawner, Current->SourceObject.Get(), NodeState);
 
 				if (K2_NodeInst == nullptr)
 				{
 					continue;
 				}
 
+				// If another task in the group already has this node, just wait for its result
+				TSharedPtr<FDocGenSharedNodeCache::FClaim, ESPMode::ThreadSafe> Claim;
+				if (SharedNodes.IsValid())
+				{
+					FDocGenSharedNodeCache::FSharedNodeFuture SharedResult;
+					Claim = SharedNodes->Claim(Spawner, Current->SourceObject.Get(), SharedResult);
+					if (!Claim.IsValid())
+					{
+						Current->DocGen->GT_DiscardSpawnedNode(K2_NodeInst, NodeState);
+						Current->Journal->AddNode(Current->SourceObjectPath);
+						Current->DeferredSharedNodes.Add({Current->SourceObjectPath, SharedResult});
+						continue;
+					}
+				}
+
+				Current->DocGen->GT_RecordNodeDependencies(K2_NodeInst, NodeState);
+
+				// Files from the last incremental run are still current, so skip rendering and serializing it.
+				// Other tasks waiting on a claim need the node body, so claimed nodes always go through the pipeline,
+				// though they are still hashed for the manifest and derived data cache like any other.
+				FNodeDocsGenerator::FDocumentedNode Unchanged;
+				if (!Claim.IsValid() && Current->DocGen->GT_CheckUnchanged(NodeState, Unchanged))
+				{
+					Current->DocGen->RetireNode(K2_NodeInst);
+					Current->Journal->AddNode(Current->SourceObjectPath);
+					Current->Manifest->RecordPackageNode(Current->SourceObjectPath, Unchanged);
+					Current->Journal->NodeFinished(Current->SourceObjectPath, &Unchanged);
+					Current->Telemetry.AddNodesDocumented();
+					++Current->UnchangedNodes;
+					continue;
+				}
+
 				// Make sure this node object will never be GCd until we're done with it.
 				K2_NodeInst->AddToRoot();
-				return K2_NodeInst;
+
+				Current->Journal->AddNode(Current->SourceObjectPath);
+				FSpawnedNode& Spawned = OutBatch.AddDefaulted_GetRef();
+				Spawned.Node = K2_NodeInst;
+				Spawned.Lease = MakeUnique<FNodeDocsGenerator::FNodeLease>(*Current->DocGen, K2_NodeInst);
+				Spawned.ObjectPath = Current->SourceObjectPath;
+				Spawned.State = MoveTemp(NodeState);
+				Spawned.Claim = MoveTemp(Claim);
 			}
 		}
 
-		// No spawners left in the queue
-		return nullptr;
-	};
-
-	auto GameThread_FinalizeDocs = [this](FString const& OutputPath) -> bool {
-		bool const Result = Current->DocGen->GT_Finalize(OutputPath);
-
-		if (!Result)
+		// False once there are no spawners left in the bucket
+		if (OutBatch.Num() == 0 && Current->NextSpawner >= Current->EndSpawner)
 		{
-			Current->Task->NotifySetText(LOCTEXT("DocFinalizationFailed", "Doc gen failed"));
-			Current->Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
-			Current->Task->NotifyExpireFadeOut();
-			// GEditor->PlayEditorSound(CompileSuccessSound);
+			// Every node of the object has been spawned, it completes once they have all left the pipeline
+			Current->Journal->EndObject(Current->SourceObjectPath);
 		}
-
-		return Result;
+		return OutBatch.Num() > 0;
 	};
 
 	/*****************************/
@@ -205,7 +400,7 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	Current->DocGen = MakeUnique<FNodeDocsGenerator>(Current->Task->Settings.OutputFormats);
 
 	auto InitDocGenResult = Async(
-		EAsyncExecution::TaskGraphMainThread, [GameThread_InitDocGen, Current = this->Current, IntermediateDir]() {
+		EAsyncExecution::TaskGraphMainThread, [GameThread_InitDocGen, Current, IntermediateDir]() {
 			return GameThread_InitDocGen(Current->Task->Settings.DocumentationTitle, IntermediateDir);
 		});
 
@@ -215,59 +410,569 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return;
 	}
 
-	bool const bCleanIntermediate = true;
-	if (bCleanIntermediate)
+	// Pick up from the journal of an interrupted run if there is one, otherwise start from a clean slate
+	Current->Journal = MakeUnique<FDocGenJournal>(IntermediateDir,
+												  FDocGenJournal::MakeSettingsSignature(Current->Task->Settings));
+	bool const bResume = Current->Task->Settings.bResumeFromCheckpoint && Current->Journal->Load();
+	// The manifest is always written, so that any run can serve as the baseline of an incremental one
+	Current->Manifest = MakeUnique<FDocGenManifest>(IntermediateDir,
+													FDocGenJournal::MakeSettingsSignature(Current->Task->Settings));
+	bool const bIncremental = Current->Task->Settings.bIncremental && Current->Manifest->Load();
+	Current->DocGen->SetManifest(Current->Manifest.Get());
+	if (Current->Task->Settings.ImageCacheSizeMB > 0)
+	{
+		Current->DocGen->SetImageCache(ImageCache.Get());
+	}
+	if (Current->Task->Settings.bUseDerivedDataCache)
+	{
+		Current->DocGen->SetDerivedData(DerivedData.Get());
+	}
+	if (!bResume && !bIncremental)
 	{
 		IFileManager::Get().DeleteDirectory(*IntermediateDir, false, true);
 	}
+	if (!Current->Journal->Open(bResume))
+	{
+		return;
+	}
+
+	// Write each priority class's doc the moment its nodes are done, rather than waiting for the whole run.
+	// The journal belongs to the task, so hold it by raw pointer.
+	FDocGenCurrentTask* const CurrentTask = Current.Get();
+	Current->Journal->OnObjectComplete.BindLambda([CurrentTask](FString const& ObjectPath) {
+		CurrentTask->Manifest->EndPackage(ObjectPath);
+
+		FString ClassId;
+		{
+			FScopeLock Lock(&CurrentTask->PriorityClassDocsLock);
+			if (!CurrentTask->PriorityClassDocs.RemoveAndCopyValue(ObjectPath, ClassId))
+			{
+				return;
+			}
+		}
+		if (CurrentTask->DocGen->PublishClassDoc(ClassId))
+		{
+			UE_LOG(LogKantanDocGen, Display, TEXT("Priority class %s is documented"), *ClassId);
+		}
+	});
+
+	// Nodes of completed objects are already on disk and only need listing in their class docs
+	int32 ResumedNodeCount = 0;
+	if (bResume)
+	{
+		for (auto const& Node : Current->Journal->GetCompletedNodes())
+		{
+			if (Current->DocGen->RegisterDocumentedNode(Node))
+			{
+				++ResumedNodeCount;
+			}
+		}
+		UE_LOG(LogKantanDocGen, Display, TEXT("Resuming from checkpoint: %d objects and %d nodes already documented"),
+			   Current->Journal->GetNumCompleteObjects(), ResumedNodeCount);
+	}
+
+	// Content packages not saved since the last run aren't loaded at all, and native modules whose reflection data is
+	// unchanged aren't walked; their docs are carried forward instead. So a watch run only spawns the nodes of what
+	// was saved or reloaded. The journal of an interrupted run doesn't say which package each node came from, so
+	// resumed runs don't record packages for the next one.
+	int32 CarriedModuleCount = 0;
+	int32 CarriedPackageCount = 0;
+	int32 CarriedNodeCount = 0;
+	Async(EAsyncExecution::TaskGraphMainThread, [&] {
+		// Docs showing types that have changed since can't be kept, however unchanged their own hash or package
+		if (bIncremental)
+		{
+			int32 const NumInvalidated = Current->Manifest->InvalidateDependents(&FNodeDocsGenerator::GT_HashType);
+			if (NumInvalidated > 0)
+			{
+				UE_LOG(LogKantanDocGen, Display, TEXT("%d nodes show types changed since the last run"),
+					   NumInvalidated);
+			}
+		}
+
+		auto CarryForward = [&](FName PackageName) {
+			TArray<FNodeDocsGenerator::FDocumentedNode> Nodes;
+			Current->Manifest->CarryPackageForward(PackageName, Nodes, Current->CarriedTypes);
+			for (auto const& Node : Nodes)
+			{
+				CarriedNodeCount += Current->DocGen->RegisterDocumentedNode(Node) ? 1 : 0;
+			}
+		};
+
+		// A module's objects all end before its entry is kept, since they are documented one by one
+		Current->NativeEnumerator->ForEachChild([&](FNativeModuleEnumerator& Enumerator) {
+			FName const PackageName = Enumerator.GetPackageName();
+			int32 const NumObjects = Enumerator.EstimatedSize();
+			if (NumObjects == 0)
+			{
+				return;
+			}
+			FString const Signature = Enumerator.GetSignature();
+			if (bIncremental && Current->Manifest->IsPackageUnchanged(PackageName, Signature))
+			{
+				CarryForward(PackageName);
+				Enumerator.RemoveAll();
+				++CarriedModuleCount;
+			}
+			else if (!bResume)
+			{
+				Current->Manifest->BeginPackage(PackageName, Signature, NumObjects);
+			}
+		});
+
+		auto FilterPackage = [&](FAssetData const& AssetData) {
+			FString const Signature = FContentPathEnumerator::GetPackageSignature(AssetData);
+			if (Signature.IsEmpty())
+			{
+				return false;
+			}
+			if (bIncremental && Current->Manifest->IsPackageUnchanged(AssetData.PackageName, Signature))
+			{
+				CarryForward(AssetData.PackageName);
+				++CarriedPackageCount;
+				return true;
+			}
+			if (!bResume)
+			{
+				Current->Manifest->BeginPackage(AssetData.PackageName, Signature);
+			}
+			return false;
+		};
+		Current->ContentEnumerator->ForEachChild(
+			[&](FContentPathEnumerator& Enumerator) { Enumerator.RemoveAssets(FilterPackage); });
+	}).Wait();
+	if (CarriedModuleCount + CarriedPackageCount > 0)
+	{
+		UE_LOG(LogKantanDocGen, Display,
+			   TEXT("Carried forward %d unchanged native modules and %d content packages with %d nodes"),
+			   CarriedModuleCount, CarriedPackageCount, CarriedNodeCount);
+	}
 
 	for (auto const& Name : Current->Task->Settings.ExcludedClasses)
 	{
 		Current->Excluded.Add(Name);
 	}
 
-	int SuccessfulNodeCount = 0;
-	while (Current->Enumerators.Dequeue(Current->CurrentEnumerator))
+	int32 const SpawnBatchSize = FMath::Max(1, Current->Task->Settings.NodeSpawnBatchSize);
+	int32 const DocTreeWorkers = Current->Task->Settings.DocTreeWorkerThreads > 0
+									 ? Current->Task->Settings.DocTreeWorkerThreads
+									 : FTaskGraphInterface::Get().GetNumWorkerThreads();
+	int32 const ImageEncodeWorkers = Current->Task->Settings.ImageEncodeWorkerThreads > 0
+										 ? Current->Task->Settings.ImageEncodeWorkerThreads
+										 : FTaskGraphInterface::Get().GetNumWorkerThreads();
+
+	/*
+	Node pipeline:
+	[Game thread steps] enumerate, spawn and render a batch -> [Batch continuations]
+		-> EncodeQueue -> [Encode workers] PNG encode and write
+		-> SerializeQueue -> [Serialize workers] doc tree generation, serialization and write
+	Everything after the game thread runs as task graph tasks, none of which block. Each stage holds back the one
+	before it while its queue is at the high-water mark, so the game thread stages can't run arbitrarily far ahead
+	of the background stages, which caps the number of rendered images held in memory.
+	*/
+	TDocGenStageQueue<FSpawnedNode> EncodeQueue(TEXT("Encode"), Current->Task->Settings.PipelineQueueCapacity);
+	TDocGenStageQueue<FSpawnedNode> SerializeQueue(TEXT("Serialize"), Current->Task->Settings.PipelineQueueCapacity);
+	FDocGenStageTimer SpawnTimer(TEXT("Spawn"));
+	FDocGenStageTimer RenderTimer(TEXT("Render"));
+	FDocGenStageTimer EncodeTimer(TEXT("Encode"));
+	FDocGenStageTimer SerializeTimer(TEXT("Serialize"));
+	FThreadSafeCounter SuccessfulNodes(ResumedNodeCount + CarriedNodeCount);
+
+	FDocGenStageWorkers SerializeWorkers(TEXT("Serialize"), DocTreeWorkers, [&]() -> bool {
+		FSpawnedNode Item;
+		if (!SerializeQueue.TryPop(Item))
+		{
+			return false;
+		}
+		if (bTerminationRequest)
+		{
+			return true;
+		}
+
+		// Generate doc
+		double const StartTime = FPlatformTime::Seconds();
+		bool const bGenerated = Current->DocGen->GenerateNodeDocTree(Item.State);
+		SerializeTimer.Add(FPlatformTime::Seconds() - StartTime);
+		if (!bGenerated)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node doc output!"))
+			Current->Journal->NodeFinished(Item.ObjectPath, nullptr);
+			return true;
+		}
+		// Nodes which are skipped rather than documented are left for the claim to publish as empty
+		if (Item.Claim.IsValid() && !Item.State.Documented.NodeId.IsEmpty())
+		{
+			Item.Claim->Fulfil(Item.State.Documented);
+		}
+		// Recorded before the node finishes, since that may complete its package
+		Current->Manifest->RecordPackageNode(Item.ObjectPath, Item.State.Documented);
+		Current->Journal->NodeFinished(Item.ObjectPath, &Item.State.Documented);
+		Current->Telemetry.AddNodesDocumented();
+		SuccessfulNodes.Increment();
+		return true;
+	});
+	TFunction<void(FSpawnedNode&&)> RenderAfterAll;
+	FDocGenStageWorkers EncodeWorkers(TEXT("Encode"), ImageEncodeWorkers, [&]() -> bool {
+		// Leave the rest until the serialize stage has room, rather than hold a task graph worker waiting for it
+		if (SerializeQueue.IsFull())
+		{
+			SerializeQueue.WhenNotFull([&] { EncodeWorkers.Kick(); });
+			return false;
+		}
+		FSpawnedNode Item;
+		if (!EncodeQueue.TryPop(Item))
+		{
+			return false;
+		}
+		if (bTerminationRequest)
+		{
+			return true;
+		}
+
+		double const StartTime = FPlatformTime::Seconds();
+		auto const SaveResult = Current->DocGen->SaveNodeImage(Item.State);
+		EncodeTimer.Add(FPlatformTime::Seconds() - StartTime);
+		if (SaveResult == FNodeDocsGenerator::ESaveImageResult::NeedsRender)
+		{
+			RenderAfterAll(MoveTemp(Item));
+			return true;
+		}
+		if (SaveResult != FNodeDocsGenerator::ESaveImageResult::Saved)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
+			Current->Journal->NodeFinished(Item.ObjectPath, nullptr);
+			return true;
+		}
+		Current->Telemetry.AddImagesWritten();
+		if (SerializeQueue.PushNoWait(MoveTemp(Item)))
+		{
+			SerializeWorkers.Kick();
+		}
+		return true;
+	});
+
+	// A node whose cached image went missing before it could be copied into place goes back to the game thread to be
+	// rendered, then round the encode stage again. The hold keeps the stage from counting as drained meanwhile.
+	RenderAfterAll = [&](FSpawnedNode&& Item) {
+		FGraphEventRef const Hold = EncodeWorkers.Hold();
+		TSharedRef<FSpawnedNode, ESPMode::ThreadSafe> Pending =
+			MakeShared<FSpawnedNode, ESPMode::ThreadSafe>(MoveTemp(Item));
+		Scheduler->RunThen(
+			[&, Pending]() -> bool {
+				if (bTerminationRequest)
+				{
+					return false;
+				}
+				FNodeDocsGenerator::FNodeImageJob Job;
+				Job.Node = Pending->Node;
+				Job.State = &Pending->State;
+				Job.bUseCaches = false;
+				Current->DocGen->GT_RenderNodeImages(MakeArrayView(&Job, 1));
+				return Job.bRendered;
+			},
+			[&, Pending, Hold](bool bRendered) {
+				{
+					FSpawnedNode Rendered = MoveTemp(*Pending);
+					if (!bRendered)
+					{
+						if (!bTerminationRequest)
+						{
+							UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
+						}
+						Current->Journal->NodeFinished(Rendered.ObjectPath, nullptr);
+					}
+					else if (EncodeQueue.PushNoWait(MoveTemp(Rendered)))
+					{
+						EncodeWorkers.Kick();
+					}
+				}
+				FDocGenStageWorkers::Release(Hold);
+			});
+	};
+
+	struct FProducedBatch
 	{
-		while (Async(EAsyncExecution::TaskGraphMainThread, [GameThread_EnumerateNextObject]() {
-				   return GameThread_EnumerateNextObject();
-			   }).Get()) // Game thread: Enumerate next Obj, get spawner list for Obj, store as
-						 // array of weak ptrs.
+		TArray<FSpawnedNode> Nodes;
+		TArray<bool> Rendered;
+		// False once every enumerator has been exhausted
+		bool bMore = false;
+	};
+
+	/*
+	Game thread: moves on to the next object or enumerator as needed, then spawns and renders a batch of nodes.
+	Batches are sized from the recent cost of a node to fit what is left of the frame budget, and the step gives up
+	the game thread early, with an empty batch, if the budget runs out or the next object is still loading.
+	*/
+	auto GameThread_ProduceNextBatch = [&]() -> FProducedBatch {
+		FProducedBatch Batch;
+		Batch.bMore = true;
+		++Current->GameThreadHops;
+		// Clear out nodes the pipeline has finished with before spawning more
+		Current->DocGen->GT_ReleaseRetiredNodes();
+		for (bool bFirst = true; !bTerminationRequest; bFirst = false)
 		{
-			if (bTerminationRequest)
+			if (!bFirst && Scheduler->GetRemainingBudget() <= 0.0)
 			{
-				return;
+				return Batch;
 			}
 
-			FNodeDocsGenerator::FNodeProcessingState NodeState;
-			while (auto NodeInst =
-					   Async(EAsyncExecution::TaskGraphMainThread, [&NodeState, GameThread_EnumerateNextNode]() {
-						   return GameThread_EnumerateNextNode(NodeState);
-					   }).Get()) // Game thread: Get next still valid spawner, spawn node, add to root, return it)
+			if (Current->SourceObject.IsValid())
 			{
-				// NodeInst should hopefully not reference anything except stuff we control (ie graph object), and
-				// it's rooted so should be safe to deal with here
+				int32 BatchSize = SpawnBatchSize;
+				if (Current->NodeCostEstimate > 0.0)
+				{
+					double const Fit = Scheduler->GetRemainingBudget() / Current->NodeCostEstimate;
+					BatchSize = FMath::FloorToInt(FMath::Clamp(Fit, 1.0, (double) SpawnBatchSize));
+				}
 
-				// Generate image
-				if (!Current->DocGen->GenerateNodeImage(NodeInst, NodeState))
+				double const SpawnStartTime = FPlatformTime::Seconds();
+				double StartTime = SpawnStartTime;
+				if (GameThread_EnumerateNextNodeBatch(Batch.Nodes, BatchSize))
 				{
-					UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
-					continue;
+					SpawnTimer.Add(FPlatformTime::Seconds() - StartTime, Batch.Nodes.Num());
+					Current->Telemetry.AddNodesSpawned(Batch.Nodes.Num());
+
+					// NodeInst should hopefully not reference anything except stuff we control (ie graph object),
+					// and it's rooted so should be safe to deal with in the background
+					// Rendered together, so the batch shares render target flushes and readbacks
+					StartTime = FPlatformTime::Seconds();
+					TArray<FNodeDocsGenerator::FNodeImageJob> ImageJobs;
+					ImageJobs.Reserve(Batch.Nodes.Num());
+					for (FSpawnedNode& Spawned : Batch.Nodes)
+					{
+						FNodeDocsGenerator::FNodeImageJob& Job = ImageJobs.AddDefaulted_GetRef();
+						Job.Node = Spawned.Node;
+						Job.State = &Spawned.State;
+					}
+					if (!bTerminationRequest)
+					{
+						Current->DocGen->GT_RenderNodeImages(ImageJobs);
+					}
+					for (auto const& Job : ImageJobs)
+					{
+						Batch.Rendered.Add(!bTerminationRequest && Job.bRendered);
+					}
+					RenderTimer.Add(FPlatformTime::Seconds() - StartTime, Batch.Nodes.Num());
+
+					double const NodeCost = (FPlatformTime::Seconds() - SpawnStartTime) / Batch.Nodes.Num();
+					Current->NodeCostEstimate = Current->NodeCostEstimate > 0.0
+													? 0.8 * Current->NodeCostEstimate + 0.2 * NodeCost
+													: NodeCost;
+					return Batch;
+				}
+				// No spawners left for this object
+				Current->SourceObject.Reset();
+			}
+			else if (Current->CurrentEnumerator.IsValid())
+			{
+				// Don't stall the game thread on a blueprint that is still loading in the background
+				if (!Current->CurrentEnumerator->IsNextReady())
+				{
+					return Batch;
 				}
+				// Enumerate next Obj, get spawner list for Obj, store as array of weak ptrs.
+				if (!GameThread_EnumerateNextObject())
+				{
+					Current->CurrentEnumerator.Reset();
+				}
+			}
+			else if (!Current->Enumerators.Dequeue(Current->CurrentEnumerator))
+			{
+				break;
+			}
+		}
+		Batch.bMore = false;
+		return Batch;
+	};
 
-				// Generate doc
-				if (!Current->DocGen->GenerateNodeDocTree(NodeInst, NodeState))
+	/*
+	Several producer lanes each keep a batch queued with the game thread scheduler. When a batch has been spawned and
+	rendered, its continuation feeds the nodes into the pipeline from a background task and, once the encode stage has
+	room, queues the lane's next batch, so the game thread always has work waiting and no thread sits blocked on a
+	round trip or a full queue.
+	*/
+	int32 const BatchesInFlight = FMath::Max(1, Current->Task->Settings.GameThreadBatchesInFlight);
+	FThreadSafeCounter ActiveLanes(BatchesInFlight);
+	FEvent* ProducerDone = FPlatformProcess::GetSynchEventFromPool(true);
+
+	TFunction<void()> QueueNextBatch;
+	QueueNextBatch = [&]() {
+		Scheduler->RunThen(GameThread_ProduceNextBatch, [&](FProducedBatch&& Batch) {
+			for (int32 Index = 0; Index < Batch.Nodes.Num(); ++Index)
+			{
+				if (!Batch.Rendered[Index])
 				{
-					UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node doc output!"))
+					if (!bTerminationRequest)
+					{
+						UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to generate node image!"))
+					}
+					Current->Journal->NodeFinished(Batch.Nodes[Index].ObjectPath, nullptr);
 					continue;
 				}
-				++SuccessfulNodeCount;
+				if (EncodeQueue.PushNoWait(MoveTemp(Batch.Nodes[Index])))
+				{
+					EncodeWorkers.Kick();
+				}
+			}
+
+			// Release the leases of nodes that didn't go on, while the generator is sure to be around. Once the last
+			// lane is done the processor can move on and destroy it.
+			bool const bMore = Batch.bMore;
+			Batch.Nodes.Reset();
+			Batch.Rendered.Reset();
+
+			// Rather than hold this task graph worker while the encode stage is at its high-water mark, the lane's
+			// next batch is queued by whichever encode worker makes room
+			EncodeQueue.WhenNotFull([&, bMore] {
+				if (bMore && !bTerminationRequest)
+				{
+					QueueNextBatch();
+				}
+				else if (ActiveLanes.Decrement() == 0)
+				{
+					// The producer state lives on the processor thread's stack, which may unwind as soon as this fires
+					ProducerDone->Trigger();
+				}
+			});
+		});
+	};
+
+	Current->Telemetry.Start();
+	for (int32 Lane = 0; Lane < BatchesInFlight; ++Lane)
+	{
+		QueueNextBatch();
+	}
+
+	// Report progress while the producer runs; a commandlet logs it, so report less often there
+	uint32 const ReportIntervalMs = IsRunningCommandlet() ? 10000 : 500;
+	while (!ProducerDone->Wait(ReportIntervalMs))
+	{
+		FText const ProgressText = Current->Telemetry.DescribeProgress();
+		Async(EAsyncExecution::TaskGraphMainThread, [Current, ProgressText] {
+			Current->Task->NotifySetText(ProgressText);
+		});
+	}
+	FPlatformProcess::ReturnSynchEventToPool(ProducerDone);
+
+	bool const bProducerCompleted = !bTerminationRequest;
+	if (!bProducerCompleted)
+	{
+		EncodeQueue.Abort();
+		SerializeQueue.Abort();
+	}
+	// An encode stage held up by a full serialize stage has no task running, so wait until each stage in turn is
+	// both empty and idle. Nothing reaches either once the stage before it is.
+	while (true)
+	{
+		EncodeWorkers.WaitUntilIdle();
+		SerializeWorkers.WaitUntilIdle();
+		if (EncodeQueue.IsEmpty() && EncodeWorkers.IsIdle() && SerializeQueue.IsEmpty() && SerializeWorkers.IsIdle())
+		{
+			break;
+		}
+	}
+	EncodeQueue.Close();
+	SerializeQueue.Close();
+	// Every node has now left the pipeline, one way or another
+	Async(EAsyncExecution::TaskGraphMainThread, [Current] { Current->DocGen->GT_ReleaseRetiredNodes(); }).Wait();
+	UE_LOG(LogKantanDocGen, Display, TEXT("Spawned nodes across %d dummy graphs"), Current->DocGen->GraphsUsed);
+	if (!bProducerCompleted || bTerminationRequest)
+	{
+		return;
+	}
+
+	// Only now wait on nodes owned by other tasks; waiting inside the pipeline could deadlock two tasks each
+	// waiting on the other's results.
+	int32 SharedNodeCount = 0;
+	for (auto const& Deferred : Current->DeferredSharedNodes)
+	{
+		while (!Deferred.Result.WaitFor(FTimespan::FromMilliseconds(50.0)))
+		{
+			if (bTerminationRequest)
+			{
+				return;
 			}
 		}
+		auto const& Result = Deferred.Result.Get();
+		if (Result.IsValid() && Current->DocGen->RegisterDocumentedNode(*Result))
+		{
+			Current->Manifest->RecordPackageNode(Deferred.ObjectPath, *Result);
+			Current->Journal->NodeFinished(Deferred.ObjectPath, Result.Get());
+			Current->Telemetry.AddNodesDocumented();
+			SuccessfulNodes.Increment();
+			++SharedNodeCount;
+		}
+		else
+		{
+			Current->Journal->NodeFinished(Deferred.ObjectPath, nullptr);
+		}
+	}
+	if (SharedNodeCount > 0)
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Registered %d nodes generated by other tasks"), SharedNodeCount);
 	}
-	for (const auto& Type : Current->TypesToParseForMembers)
+
+	int32 const SuccessfulNodeCount = SuccessfulNodes.GetValue() + Current->UnchangedNodes;
+	UE_LOG(LogKantanDocGen, Display,
+		   TEXT("Documented %d nodes using %d game thread steps (spawn batch size %d, %d batches in flight), "
+				"skipped %d already documented, %d unchanged since the last run"),
+		   SuccessfulNodeCount, Current->GameThreadHops, SpawnBatchSize, BatchesInFlight,
+		   Current->DocGen->DuplicateNodesSkipped, Current->UnchangedNodes);
+	UE_LOG(LogKantanDocGen, Display, TEXT("Throughput: %s"), *Current->Telemetry.DescribeSummary());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *SpawnTimer.DescribeStats());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *RenderTimer.DescribeStats());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *EncodeQueue.DescribeStats());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *EncodeWorkers.DescribeStats());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *EncodeTimer.DescribeStats());
+	if (Current->Task->Settings.ImageCacheSizeMB > 0)
 	{
-		Current->DocGen->GenerateTypeMembers(Type.Get());
+		UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *ImageCache->DescribeStats());
+	}
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *SerializeQueue.DescribeStats());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *SerializeWorkers.DescribeStats());
+	UE_LOG(LogKantanDocGen, Display, TEXT("%s"), *SerializeTimer.DescribeStats());
+
+	// Copy what type docs need out of the reflection data in one game thread pass, then build the docs in parallel
+	TArray<FNodeDocsGenerator::FTypeSnapshot> TypeSnapshots;
+	Async(EAsyncExecution::TaskGraphMainThread, [Current, &TypeSnapshots] {
+		TSet<UObject*> Seen;
+		for (const auto& Type : Current->TypesToParseForMembers)
+		{
+			bool bAlreadySeen = false;
+			Seen.Add(Type.Get(), &bAlreadySeen);
+			FNodeDocsGenerator::FTypeSnapshot Snapshot;
+			if (!bAlreadySeen && FNodeDocsGenerator::GT_SnapshotType(Type.Get(), Snapshot))
+			{
+				Current->Manifest->RecordPackageType(Type->GetPathName(), Snapshot);
+				TypeSnapshots.Add(MoveTemp(Snapshot));
+			}
+		}
+	}).Wait();
+	// Carried packages weren't loaded, so their types are documented from the snapshots taken by the last run
+	{
+		TSet<FString> SnapshotIds;
+		for (auto const& Snapshot : TypeSnapshots)
+		{
+			SnapshotIds.Add(Snapshot.Id);
+		}
+		for (auto& Snapshot : Current->CarriedTypes)
+		{
+			if (!SnapshotIds.Contains(Snapshot.Id))
+			{
+				TypeSnapshots.Add(MoveTemp(Snapshot));
+			}
+		}
+		Current->CarriedTypes.Empty();
+	}
+	ParallelFor(TypeSnapshots.Num(), [&](int32 Index) {
+		if (!bTerminationRequest)
+		{
+			Current->DocGen->GenerateTypeMembers(TypeSnapshots[Index]);
+		}
+	});
+	if (bTerminationRequest)
+	{
+		return;
 	}
 	// TODO: Generate any other blueprint types and associated data here
 	// rather than enqueing the enumerator for other bp types, simply have one of each and deal with them here
@@ -275,7 +980,7 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	if (SuccessfulNodeCount == 0)
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("No nodes were found to document!"));
-		Async(EAsyncExecution::TaskGraphMainThread, [this] {
+		Async(EAsyncExecution::TaskGraphMainThread, [Current] {
 			Current->Task->NotifySetText(LOCTEXT("DocFinalizationFailed", "Doc gen failed - No nodes found"));
 			Current->Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
 			Current->Task->NotifyExpireFadeOut();
@@ -284,17 +989,27 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return;
 	}
 
-	// Game thread: DocGen.GT_Finalize()
-	auto FinalizeResult = Async(EAsyncExecution::TaskGraphMainThread, [GameThread_FinalizeDocs, IntermediateDir]() {
-		return GameThread_FinalizeDocs(IntermediateDir);
-	});
-	if (!FinalizeResult.Get())
+	if (bTerminationRequest)
+	{
+		return;
+	}
+
+	// Serializing the class, struct and enum docs can take a while, so keep it off the game thread
+	if (!Current->DocGen->Finalize(IntermediateDir))
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to finalize xml docs!"));
+		Async(EAsyncExecution::TaskGraphMainThread, [Current] {
+			Current->Task->NotifySetText(LOCTEXT("DocFinalizationFailed", "Doc gen failed"));
+			Current->Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
+			Current->Task->NotifyExpireFadeOut();
+		});
+		// GEditor->PlayEditorSound(CompileSuccessSound);
 		return;
 	}
+	// Everything the manifest describes is now on disk
+	Current->Manifest->Save();
 	Async(EAsyncExecution::TaskGraphMainThread,
-		  [this] { Current->Task->NotifySetText(LOCTEXT("DocConversionInProgress", "Converting docs")); });
+		  [Current] { Current->Task->NotifySetText(LOCTEXT("DocConversionInProgress", "Converting docs")); });
 
 	if (Current->Task->Settings.bCleanOutputDirectory)
 	{
@@ -310,11 +1025,34 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	EIntermediateProcessingResult TransformationResult = Success;
 	for (const auto& OutputFormatFactory : Current->Task->Settings.OutputFormats)
 	{
+		if (bTerminationRequest)
+		{
+			return;
+		}
+
 		auto IntermediateProcessor = OutputFormatFactory->CreateIntermediateDocProcessor();
+		{
+			FScopeLock Lock(&ActiveOutputProcessorsLock);
+			ActiveOutputProcessors.Add(IntermediateProcessor);
+		}
+		// Stop may have run before the processor was registered
+		if (bTerminationRequest)
+		{
+			IntermediateProcessor->Cancel();
+		}
+
 		EIntermediateProcessingResult Result = IntermediateProcessor->ProcessIntermediateDocs(
 			IntermediateDir, Current->Task->Settings.OutputDirectory.Path, Current->Task->Settings.DocumentationTitle,
 			Current->Task->Settings.bCleanOutputDirectory);
+		{
+			FScopeLock Lock(&ActiveOutputProcessorsLock);
+			ActiveOutputProcessors.Remove(IntermediateProcessor);
+		}
 
+		if (Result == EIntermediateProcessingResult::Cancelled)
+		{
+			return;
+		}
 		if (Result != EIntermediateProcessingResult::Success)
 		{
 			TransformationResult = Result;
@@ -332,7 +1070,7 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 											   "Could not write output, please clear output directory or "
 											   "enable 'Clean Output Directory' option")
 									 : LOCTEXT("GenericTransformationFailure", "Conversion failure"));
-		Async(EAsyncExecution::TaskGraphMainThread, [this, Msg] {
+		Async(EAsyncExecution::TaskGraphMainThread, [Current, Msg] {
 			Current->Task->NotifySetText(Msg);
 			Current->Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
 			Current->Task->NotifyExpireFadeOut();
@@ -342,7 +1080,10 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return;
 	}
 
-	Async(EAsyncExecution::TaskGraphMainThread, [Current = this->Current] {
+	// Nothing left to resume
+	Current->Journal->Discard();
+
+	Async(EAsyncExecution::TaskGraphMainThread, [Current] {
 		FString HyperlinkTarget =
 			TEXT("file://") /
 			FPaths::ConvertRelativePathToFull(Current->Task->Settings.OutputDirectory.Path /
@@ -364,7 +1105,7 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	});
 }
 
-FDocGenTaskProcessor::FDocGenTask::FDocGenTask()
+FDocGenTaskProcessor::FDocGenTask::FDocGenTask(FSimpleDelegate const& OnCancelClicked)
 {
 	if (!IsRunningCommandlet())
 	{
@@ -378,6 +1119,9 @@ FDocGenTaskProcessor::FDocGenTask::FDocGenTask()
 		Info.bUseLargeFont = true;
 		Info.bFireAndForget = false;
 		Info.bAllowThrottleWhenFrameRateIsLow = false;
+		Info.ButtonDetails.Add(FNotificationButtonInfo(LOCTEXT("DocGenCancel", "Cancel"),
+													   LOCTEXT("DocGenCancelTooltip", "Stop generating documentation"),
+													   OnCancelClicked, SNotificationItem::CS_Pending));
 
 		Notification = FSlateNotificationManager::Get().AddNotification(Info);
 	}
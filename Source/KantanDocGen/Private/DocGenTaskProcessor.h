@@ -6,18 +6,32 @@
 
 #pragma once
 
+#include "DocGenActionIndex.h"
+#include "DocGenDerivedData.h"
+#include "DocGenGameThreadScheduler.h"
+#include "DocGenImageCache.h"
+#include "DocGenJournal.h"
+#include "DocGenManifest.h"
 #include "DocGenSettings.h"
+#include "DocGenSharedNodeCache.h"
+#include "DocGenTelemetry.h"
+#include "Enumeration/CompositeEnumerator.h"
+#include "Enumeration/ContentPathEnumerator.h"
+#include "Enumeration/NativeModuleEnumerator.h"
+#include "NodeDocsGenerator.h"
 
 #include "Containers/Queue.h"
 #include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
 #include "HAL/Runnable.h"
 #include "HAL/ThreadSafeBool.h"
 #include "UObject/WeakObjectPtrTemplates.h"
 
 class ISourceObjectEnumerator;
-class FNodeDocsGenerator;
+struct IDocGenOutputProcessor;
 
 class UBlueprintNodeSpawner;
+class UK2Node;
 
 class FDocGenTaskProcessor : public FRunnable
 {
@@ -27,6 +41,8 @@ public:
 public:
 	void QueueTask(FKantanDocGenSettings const& Settings);
 	bool IsRunning() const;
+	/** Claims the processor for a new Run, returning false if one is already in progress */
+	bool TryStartRunning();
 
 public:
 	virtual bool Init() override;
@@ -43,7 +59,7 @@ protected:
 		TSharedPtr<class SNotificationItem> Notification;
 
 	public:
-		FDocGenTask();
+		FDocGenTask(FSimpleDelegate const& OnCancelClicked);
 		// Begin safe wrappers around notification functions
 		void NotifyExpireDuration(float Duration);
 		void NotifyExpireFadeOut();
@@ -59,15 +75,63 @@ protected:
 		TSharedPtr<FDocGenTask> Task;
 
 		TQueue<TSharedPtr<ISourceObjectEnumerator>> Enumerators;
+		// Every enumerator of the task, including those already finished, for progress estimates
+		TArray<TSharedPtr<ISourceObjectEnumerator>> AllEnumerators;
+		// Also in AllEnumerators, kept to drop unchanged modules and packages before enumeration starts
+		TSharedPtr<FCompositeEnumerator<FNativeModuleEnumerator>> NativeEnumerator;
+		TSharedPtr<FCompositeEnumerator<FContentPathEnumerator>> ContentEnumerator;
+		// Types of the modules and content packages carried forward from the last run without being walked
+		TArray<FNodeDocsGenerator::FTypeSnapshot> CarriedTypes;
 		TSet<FName> Excluded;
 		TSet<TWeakObjectPtr<UObject>> Processed;
 
 		TSharedPtr<ISourceObjectEnumerator> CurrentEnumerator;
+		// Enumerates the priority classes ahead of everything else
+		TSharedPtr<ISourceObjectEnumerator> PriorityEnumerator;
+		// Class doc ids of the priority source objects being documented, keyed on object path
+		TMap<FString, FString> PriorityClassDocs;
+		FCriticalSection PriorityClassDocsLock;
 		TWeakObjectPtr<UObject> SourceObject;
+		// Path of SourceObject, safe to use off the game thread
+		FString SourceObjectPath;
 		TArray<TWeakObjectPtr<UObject>> TypesToParseForMembers;
-		TQueue<TWeakObjectPtr<UBlueprintNodeSpawner>> CurrentSpawners;
+		// Spawners of every object in scope, and the part of SourceObject's bucket still to be spawned
+		FDocGenActionIndex ActionIndex;
+		int32 NextSpawner = 0;
+		int32 EndSpawner = 0;
 
+		// Outlives DocGen, which records into it
+		TUniquePtr<FDocGenManifest> Manifest;
 		TUniquePtr<FNodeDocsGenerator> DocGen;
+		TUniquePtr<FDocGenJournal> Journal;
+		FDocGenTelemetry Telemetry;
+
+		// Number of game thread steps taken to enumerate objects and spawn and render nodes
+		int32 GameThreadHops = 0;
+		// Game thread only. Nodes left as they were by the last incremental run.
+		int32 UnchangedNodes = 0;
+		// Recent game thread cost of spawning and rendering one node, used to fit batches to the frame budget
+		double NodeCostEstimate = 0.0;
+
+		// Nodes being generated by another task in the same group, registered once this task's pipeline has drained
+		struct FDeferredSharedNode
+		{
+			FString ObjectPath;
+			FDocGenSharedNodeCache::FSharedNodeFuture Result;
+		};
+		TArray<FDeferredSharedNode> DeferredSharedNodes;
+	};
+
+	// A node spawned on the game thread, along with the state needed to document it
+	struct FSpawnedNode
+	{
+		UK2Node* Node = nullptr;
+		// Releases Node once this item leaves the pipeline, however it leaves
+		TUniquePtr<FNodeDocsGenerator::FNodeLease> Lease;
+		FString ObjectPath;
+		FNodeDocsGenerator::FNodeProcessingState State;
+		// Set when other tasks in the group are waiting on this node
+		TSharedPtr<FDocGenSharedNodeCache::FClaim, ESPMode::ThreadSafe> Claim;
 	};
 
 	struct FDocGenOutputTask
@@ -76,11 +140,20 @@ protected:
 	};
 
 protected:
-	void ProcessTask(TSharedPtr<FDocGenTask> InTask);
+	void ProcessTaskGroup(TArray<TSharedPtr<FDocGenTask>> const& Group);
+	void ProcessTask(TSharedPtr<FDocGenTask> InTask, TSharedPtr<FDocGenSharedNodeCache> SharedNodes);
+	void NotifyCancelled(TSharedPtr<FDocGenTask> Task);
 
 protected:
 	TQueue<TSharedPtr<FDocGenTask>> Waiting;
-	TSharedPtr<FDocGenCurrentTask> Current;
+	// Shared by all running tasks, so the budget applies to doc gen as a whole
+	TUniquePtr<FDocGenGameThreadScheduler> Scheduler;
+	// Kept for the life of the processor, so the cache directory is only scanned once. Processor thread only.
+	TUniquePtr<FDocGenImageCache> ImageCache;
+	TUniquePtr<FDocGenDerivedData> DerivedData;
+	// Output processors currently converting docs, so that Stop can cancel them
+	TArray<TSharedPtr<IDocGenOutputProcessor>> ActiveOutputProcessors;
+	FCriticalSection ActiveOutputProcessorsLock;
 	// TQueue< TSharedPtr< FDocGenOutputTask > > Converting;
 
 	FThreadSafeBool bRunning; // @NOTE: Using this to sync with module calls from game thread is not 100% okay (we're
@@ -0,0 +1,96 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "DocGenTelemetry.h"
+#include "Enumeration/ISourceObjectEnumerator.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Timespan.h"
+
+#define LOCTEXT_NAMESPACE "KantanDocGen"
+
+FDocGenTelemetry::FDocGenTelemetry()
+	: StartTime(FPlatformTime::Seconds())
+	, Progress(0.0f)
+{}
+
+void FDocGenTelemetry::Start()
+{
+	StartTime = FPlatformTime::Seconds();
+}
+
+void FDocGenTelemetry::UpdateProgress(TArray<TSharedPtr<ISourceObjectEnumerator>> const& Enumerators)
+{
+	int64 TotalSize = 0;
+	double Completed = 0.0;
+	for (auto const& Enumerator : Enumerators)
+	{
+		int32 const Size = Enumerator->EstimatedSize();
+		TotalSize += Size;
+		Completed += FMath::Clamp(Enumerator->EstimateProgress(), 0.0f, 1.0f) * Size;
+	}
+
+	FScopeLock Lock(&CS);
+	Progress = TotalSize > 0 ? (float) (Completed / TotalSize) : 0.0f;
+}
+
+double FDocGenTelemetry::GetElapsedSeconds() const
+{
+	return FPlatformTime::Seconds() - StartTime;
+}
+
+double FDocGenTelemetry::EstimateRemainingSeconds() const
+{
+	FScopeLock Lock(&CS);
+	double const Elapsed = GetElapsedSeconds();
+	// The first few percent are dominated by setup and tell us little about the rate
+	if (Progress < 0.01f || Elapsed < 1.0)
+	{
+		return -1.0;
+	}
+	return Elapsed / Progress * (1.0f - Progress);
+}
+
+FText FDocGenTelemetry::DescribeProgress() const
+{
+	double const Elapsed = FMath::Max(GetElapsedSeconds(), 0.001);
+	float CurrentProgress;
+	{
+		FScopeLock Lock(&CS);
+		CurrentProgress = Progress;
+	}
+
+	FNumberFormattingOptions RateFormat;
+	RateFormat.MinimumFractionalDigits = 1;
+	RateFormat.MaximumFractionalDigits = 1;
+
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("Progress"), FText::AsPercent(CurrentProgress));
+	Args.Add(TEXT("ObjectRate"), FText::AsNumber(Objects.GetValue() / Elapsed, &RateFormat));
+	Args.Add(TEXT("NodeRate"), FText::AsNumber(NodesDocumented.GetValue() / Elapsed, &RateFormat));
+	Args.Add(TEXT("ImageRate"), FText::AsNumber(ImagesWritten.GetValue() / Elapsed, &RateFormat));
+
+	double const Remaining = EstimateRemainingSeconds();
+	Args.Add(TEXT("Eta"), Remaining >= 0.0 ? FText::AsTimespan(FTimespan::FromSeconds(FMath::CeilToDouble(Remaining)))
+										  : LOCTEXT("DocGenEtaUnknown", "--"));
+
+	return FText::Format(LOCTEXT("DocGenProgress",
+								 "Doc gen in progress: {Progress}\n"
+								 "{ObjectRate} objects/s, {NodeRate} nodes/s, {ImageRate} images/s, ETA {Eta}"),
+						 Args);
+}
+
+FString FDocGenTelemetry::DescribeSummary() const
+{
+	double const Elapsed = FMath::Max(GetElapsedSeconds(), 0.001);
+	return FString::Printf(TEXT("%d objects (%.1f/s), %d nodes spawned (%.1f/s), %d images (%.1f/s), %d nodes "
+								"documented (%.1f/s) in %.1fs"),
+						   Objects.GetValue(), Objects.GetValue() / Elapsed, NodesSpawned.GetValue(),
+						   NodesSpawned.GetValue() / Elapsed, ImagesWritten.GetValue(), ImagesWritten.GetValue() / Elapsed,
+						   NodesDocumented.GetValue(), NodesDocumented.GetValue() / Elapsed, Elapsed);
+}
+
+#undef LOCTEXT_NAMESPACE
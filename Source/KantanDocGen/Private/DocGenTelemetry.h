@@ -0,0 +1,53 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+
+class ISourceObjectEnumerator;
+
+/*
+Live progress of a doc gen task: how far through its sources the enumerators are, and how many objects, nodes and
+images each stage has got through. Counters may be bumped from any thread.
+*/
+class FDocGenTelemetry
+{
+public:
+	FDocGenTelemetry();
+
+	void Start();
+
+	void AddObjects(int32 Count = 1) { Objects.Add(Count); }
+	void AddNodesSpawned(int32 Count = 1) { NodesSpawned.Add(Count); }
+	void AddImagesWritten(int32 Count = 1) { ImagesWritten.Add(Count); }
+	void AddNodesDocumented(int32 Count = 1) { NodesDocumented.Add(Count); }
+
+	/** Samples overall progress from the enumerators, weighted by their size. Game thread only. */
+	void UpdateProgress(TArray<TSharedPtr<ISourceObjectEnumerator>> const& Enumerators);
+
+	/** Short progress line for the notification */
+	FText DescribeProgress() const;
+	/** Totals and rates for the log */
+	FString DescribeSummary() const;
+
+protected:
+	double GetElapsedSeconds() const;
+	// Estimated seconds remaining, or a negative value while there is too little to go on
+	double EstimateRemainingSeconds() const;
+
+protected:
+	double StartTime;
+	FThreadSafeCounter Objects;
+	FThreadSafeCounter NodesSpawned;
+	FThreadSafeCounter ImagesWritten;
+	FThreadSafeCounter NodesDocumented;
+
+	mutable FCriticalSection CS;
+	float Progress;
+};
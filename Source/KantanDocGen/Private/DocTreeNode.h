@@ -3,6 +3,8 @@
 #include "Containers/UnrealString.h"
 #include "CoreMinimal.h"
 #include "Misc/Optional.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/Archive.h"
 #include "Templates/SharedPointer.h"
 #include "VariantWrapper.h"
 
@@ -80,6 +82,161 @@ public:
 		return NewChild;
 	}
 
+	// Shares (rather than copies) every child of another object node, so the shared children must not be modified
+	void AppendChildrenOf(const DocTreeNode& Other)
+	{
+		if (CurrentDataType == InternalDataType::Null)
+		{
+			Value.Set<Object>(Object());
+			CurrentDataType = InternalDataType::Object;
+		}
+		auto ObjPtr = Value.TryGet<Object>();
+		check(ObjPtr);
+		const Object* OtherPtr = Other.Value.TryGet<Object>();
+		check(OtherPtr);
+		for (const auto& Child : *OtherPtr)
+		{
+			ObjPtr->Add(Child.Key, Child.Value);
+		}
+	}
+
+	// Deep copy. Only reads this tree, so it is safe to clone a finished tree from several threads at once
+	TSharedPtr<DocTreeNode> Clone() const
+	{
+		TSharedPtr<DocTreeNode> Copy = MakeShared<DocTreeNode>();
+		Copy->CurrentDataType = CurrentDataType;
+		Copy->bValueRequiresEscaping = bValueRequiresEscaping;
+		switch (CurrentDataType)
+		{
+			case InternalDataType::Object:
+			{
+				Object Children;
+				for (const auto& Child : Value.Get<Object>())
+				{
+					Children.Add(Child.Key, Child.Value->Clone());
+				}
+				Copy->Value.Set<Object>(MoveTemp(Children));
+				break;
+			}
+			case InternalDataType::String:
+				Copy->Value.Set<FString>(Value.Get<FString>());
+				break;
+			case InternalDataType::Null:
+				break;
+		}
+		return Copy;
+	}
+
+	// Feeds the tree's contents into Md5, so that trees built the same way hash the same. Only reads this tree.
+	void UpdateHash(FMD5& Md5) const
+	{
+		auto UpdateWithString = [&Md5](const FString& String) {
+			FTCHARToUTF8 Utf8(*String);
+			// Include the terminator, so that adjacent strings can't run into each other
+			Md5.Update((const uint8*) Utf8.Get(), Utf8.Length() + 1);
+		};
+
+		uint8 const DataType = (uint8) CurrentDataType;
+		Md5.Update(&DataType, 1);
+		switch (CurrentDataType)
+		{
+			case InternalDataType::Object:
+				for (const auto& Child : Value.Get<Object>())
+				{
+					UpdateWithString(Child.Key);
+					Child.Value->UpdateHash(Md5);
+				}
+				UpdateWithString(FString());
+				break;
+			case InternalDataType::String:
+				UpdateWithString(Value.Get<FString>());
+				break;
+			case InternalDataType::Null:
+				break;
+		}
+	}
+
+	// Binary form of the tree, for keeping it between runs
+	void Save(FArchive& Ar) const
+	{
+		check(Ar.IsSaving());
+		uint8 DataType = (uint8) CurrentDataType;
+		bool bEscape = bValueRequiresEscaping;
+		Ar << DataType << bEscape;
+		switch (CurrentDataType)
+		{
+			case InternalDataType::Object:
+			{
+				int32 NumChildren = Value.Get<Object>().Num();
+				Ar << NumChildren;
+				for (const auto& Child : Value.Get<Object>())
+				{
+					FString Key = Child.Key;
+					Ar << Key;
+					Child.Value->Save(Ar);
+				}
+				break;
+			}
+			case InternalDataType::String:
+			{
+				FString String = Value.Get<FString>();
+				Ar << String;
+				break;
+			}
+			case InternalDataType::Null:
+				break;
+		}
+	}
+
+	// Reads a tree written by Save. Returns null if the data is malformed.
+	static TSharedPtr<DocTreeNode> Load(FArchive& Ar)
+	{
+		check(Ar.IsLoading());
+		uint8 DataType = 0;
+		bool bEscape = false;
+		Ar << DataType << bEscape;
+		if (Ar.IsError() || DataType > (uint8) InternalDataType::Null)
+		{
+			return nullptr;
+		}
+
+		TSharedPtr<DocTreeNode> Node = MakeShared<DocTreeNode>();
+		Node->CurrentDataType = (InternalDataType) DataType;
+		Node->bValueRequiresEscaping = bEscape;
+		switch (Node->CurrentDataType)
+		{
+			case InternalDataType::Object:
+			{
+				int32 NumChildren = 0;
+				Ar << NumChildren;
+				Object Children;
+				for (int32 Index = 0; Index < NumChildren && !Ar.IsError(); ++Index)
+				{
+					FString Key;
+					Ar << Key;
+					TSharedPtr<DocTreeNode> Child = Load(Ar);
+					if (!Child.IsValid())
+					{
+						return nullptr;
+					}
+					Children.Add(Key, Child);
+				}
+				Node->Value.Set<Object>(MoveTemp(Children));
+				break;
+			}
+			case InternalDataType::String:
+			{
+				FString String;
+				Ar << String;
+				Node->Value.Set<FString>(MoveTemp(String));
+				break;
+			}
+			case InternalDataType::Null:
+				break;
+		}
+		return Ar.IsError() ? nullptr : Node;
+	}
+
 	TSharedPtr<DocTreeNode> AppendChildWithValue(const FString& ChildName, const FString& NewValue)
 	{
 		TSharedPtr<DocTreeNode> NewChild = AppendChild(ChildName);
@@ -0,0 +1,103 @@
+#include "DoxygenParserHelpers.h"
+#include "Misc/Char.h"
+
+namespace Detail
+{
+	void ParseDoxygenTags(FStringView RawDoxygenString, FDoxygenTags& OutTags)
+	{
+		OutTags.Reset();
+
+		TCHAR const* const Str = RawDoxygenString.GetData();
+		int32 const RawStringLength = RawDoxygenString.Len();
+		int32 CurStrPos = 0;
+		// parse the full function tooltip text, looking for tag lines
+		while (CurStrPos < RawStringLength)
+		{
+			while (CurStrPos < RawStringLength && Str[CurStrPos] != TEXT('@'))
+			{
+				++CurStrPos;
+			}
+			if (CurStrPos >= RawStringLength) // if the tag wasn't found
+			{
+				break;
+			}
+			CurStrPos++;
+
+			FDoxygenTags::FTag& Tag = OutTags.Tags.AddDefaulted_GetRef();
+			int32 const TagStart = CurStrPos;
+			while (CurStrPos < RawStringLength && !FChar::IsWhitespace(Str[CurStrPos]))
+			{
+				CurStrPos++;
+			}
+			Tag.Name.Start = OutTags.Buffer.Num();
+			Tag.Name.Len = CurStrPos - TagStart;
+			OutTags.Buffer.Append(Str + TagStart, Tag.Name.Len);
+
+			// advance past whitespace (get to the meat of the comment)
+			while (CurStrPos < RawStringLength && FChar::IsWhitespace(Str[CurStrPos]))
+			{
+				++CurStrPos;
+			}
+
+			Tag.Value.Start = OutTags.Buffer.Num();
+			// collect the param/return-val description
+			while (CurStrPos < RawStringLength && Str[CurStrPos] != TEXT('@'))
+			{
+				// advance past newline
+				while (CurStrPos < RawStringLength && FChar::IsLinebreak(Str[CurStrPos]))
+				{
+					++CurStrPos;
+
+					// advance past whitespace at the start of a new line
+					while (CurStrPos < RawStringLength && FChar::IsWhitespace(Str[CurStrPos]))
+					{
+						++CurStrPos;
+					}
+
+					// replace the newline with a single space
+					if (CurStrPos < RawStringLength && !FChar::IsLinebreak(Str[CurStrPos]))
+					{
+						OutTags.Buffer.Add(TEXT(' '));
+					}
+
+					if (CurStrPos < RawStringLength && Str[CurStrPos] == TEXT('*'))
+					{
+						++CurStrPos;
+						// skip whitespace after an asterisk in a multiline comment
+						while (CurStrPos < RawStringLength && FChar::IsWhitespace(Str[CurStrPos]))
+						{
+							++CurStrPos;
+						}
+					}
+				}
+
+				if (CurStrPos < RawStringLength && Str[CurStrPos] != TEXT('@'))
+				{
+					OutTags.Buffer.Add(Str[CurStrPos++]);
+				}
+			}
+
+			// trim any trailing whitespace from the descriptive text, and what is left of the comment's closing
+			TCHAR const* const Value = OutTags.Buffer.GetData() + Tag.Value.Start;
+			int32 ValueLen = OutTags.Buffer.Num() - Tag.Value.Start;
+			auto TrimEnd = [Value, &ValueLen]() {
+				while (ValueLen > 0 && FChar::IsWhitespace(Value[ValueLen - 1]))
+				{
+					--ValueLen;
+				}
+			};
+			TrimEnd();
+			if (ValueLen > 0 && Value[ValueLen - 1] == TEXT('/'))
+			{
+				--ValueLen;
+			}
+			if (ValueLen > 0 && Value[ValueLen - 1] == TEXT('*'))
+			{
+				--ValueLen;
+			}
+			TrimEnd();
+			// The trimmed characters are left in the buffer, past the end of the span
+			Tag.Value.Len = ValueLen;
+		}
+	}
+} // namespace Detail
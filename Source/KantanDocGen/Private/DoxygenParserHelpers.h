@@ -1,95 +1,80 @@
 #pragma once
 #include "Containers/Array.h"
-#include "Containers/Map.h"
+#include "Containers/StringView.h"
 #include "Containers/UnrealString.h"
 
 namespace Detail
 {
-	TMap<FString, TArray<FString>> ParseDoxygenTagsForString(const FString& RawDoxygenString)
+	/*
+	The '@' tags of a doxygen comment. Tag names and their cleaned up values are written back to back into a single
+	buffer, and tags refer to them by offset, so parsing a comment costs two growable arrays and no per-tag strings.
+	*/
+	struct FDoxygenTags
 	{
-		TMap<FString, TArray<FString>> ParsedTags;
-		int32 CurStrPos = 0;
-		int32 RawStringLength = RawDoxygenString.Len();
-		// parse the full function tooltip text, looking for tag lines
-		do
+		struct FSpan
 		{
-			CurStrPos = RawDoxygenString.Find("@", ESearchCase::IgnoreCase, ESearchDir::FromStart, CurStrPos);
-			if (CurStrPos == INDEX_NONE) // if the tag wasn't found
-			{
-				break;
-			}
-			CurStrPos++;
-			FString CurrentTagString;
-			while (CurStrPos < RawStringLength && !FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
-			{
-				CurrentTagString.AppendChar(RawDoxygenString[CurStrPos]);
-				CurStrPos++;
-			}
+			int32 Start = 0;
+			int32 Len = 0;
+		};
 
-			// advance past whitespace
-			while (CurStrPos < RawStringLength && FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
-			{
-				++CurStrPos;
-			}
+		struct FTag
+		{
+			FSpan Name;
+			FSpan Value;
+		};
 
-			// advance past whitespace (get to the meat of the comment)
-			// since many doxygen style @param use the format "@param <param name> - <comment>" we also strip - if it is
-			// before we get to any other non-whitespace
-			while (CurStrPos < RawStringLength &&
-				   (FChar::IsWhitespace(RawDoxygenString[CurStrPos])))
-			{
-				++CurStrPos;
-			}
+		TArray<TCHAR> Buffer;
+		// In comment order
+		TArray<FTag> Tags;
 
-			FString CurrentValueString;
-			// collect the param/return-val description
-			while (CurStrPos < RawStringLength && RawDoxygenString[CurStrPos] != TEXT('@'))
-			{
-				// advance past newline
-				while (CurStrPos < RawStringLength && FChar::IsLinebreak(RawDoxygenString[CurStrPos]))
-				{
-					++CurStrPos;
+		FStringView GetString(FSpan const& Span) const
+		{
+			return FStringView(Buffer.GetData() + Span.Start, Span.Len);
+		}
 
-					// advance past whitespace at the start of a new line
-					while (CurStrPos < RawStringLength && FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
-					{
-						++CurStrPos;
-					}
+		bool IsEmpty() const
+		{
+			return Tags.Num() == 0;
+		}
 
-					// replace the newline with a single space
-					if (CurStrPos < RawStringLength && !FChar::IsLinebreak(RawDoxygenString[CurStrPos]))
-					{
-						CurrentValueString.AppendChar(TEXT(' '));
-					}
+		void Reset()
+		{
+			Buffer.Reset();
+			Tags.Reset();
+		}
 
-					if (CurStrPos < RawStringLength && RawDoxygenString[CurStrPos] == TEXT('*'))
-					{
-						++CurStrPos;
-						// skip whitespace after an asterisk in a multiline comment
-						while (CurStrPos < RawStringLength && FChar::IsWhitespace(RawDoxygenString[CurStrPos]))
-						{
-							++CurStrPos;
-						}
-					}
+		/** Calls Visitor(Name, Value) for every tag, grouping the values of a tag in the order of its first use */
+		template <typename TVisitor>
+		void ForEachTag(TVisitor&& Visitor) const
+		{
+			// Comments have a handful of tags, so finding repeats by scanning beats building a map
+			for (int32 TagIdx = 0; TagIdx < Tags.Num(); ++TagIdx)
+			{
+				FStringView const Name = GetString(Tags[TagIdx].Name);
+				bool bSeen = false;
+				for (int32 PrevIdx = 0; PrevIdx < TagIdx && !bSeen; ++PrevIdx)
+				{
+					bSeen = GetString(Tags[PrevIdx].Name).Equals(Name, ESearchCase::CaseSensitive);
+				}
+				if (bSeen)
+				{
+					continue;
 				}
 
-				if (CurStrPos < RawStringLength && RawDoxygenString[CurStrPos] != TEXT('@'))
+				for (int32 SameIdx = TagIdx; SameIdx < Tags.Num(); ++SameIdx)
 				{
-					CurrentValueString.AppendChar(RawDoxygenString[CurStrPos++]);
+					if (SameIdx == TagIdx || GetString(Tags[SameIdx].Name).Equals(Name, ESearchCase::CaseSensitive))
+					{
+						Visitor(Name, GetString(Tags[SameIdx].Value));
+					}
 				}
 			}
+		}
+	};
 
-			// trim any trailing whitespace from the descriptive text
-			CurrentValueString.TrimEndInline();
-			CurrentValueString.RemoveFromEnd("/");
-			CurrentValueString.RemoveFromEnd("*");
-			CurrentValueString.TrimEndInline();
-
-			TArray<FString>& ExistingValuesForCurrentTag = ParsedTags.FindOrAdd(CurrentTagString);
-			ExistingValuesForCurrentTag.Add(CurrentValueString);
-
-		} while (CurStrPos < RawStringLength);
-
-		return ParsedTags;
-	}
-} // namespace Detail
\ No newline at end of file
+	/**
+	 * Replaces OutTags with the tags of RawDoxygenString, in a single pass over it. Each value runs up to the next
+	 * '@', with line breaks and the leading asterisks of comment lines folded into single spaces.
+	 */
+	void ParseDoxygenTags(FStringView RawDoxygenString, FDoxygenTags& OutTags);
+} // namespace Detail
@@ -45,9 +45,14 @@ public:
 		return nullptr;
 	}
 
+	virtual bool IsNextReady() override
+	{
+		return CurEnumIndex >= ChildEnumList.Num() || ChildEnumList[CurEnumIndex]->IsNextReady();
+	}
+
 	virtual float EstimateProgress() const override
 	{
-		if(CurEnumIndex < ChildEnumList.Num())
+		if(CurEnumIndex < ChildEnumList.Num() && TotalSize > 0)
 		{
 			return (float)(Completed + ChildEnumList[CurEnumIndex]->EstimateProgress() * ChildEnumList[CurEnumIndex]->EstimatedSize()) / TotalSize;
 		}
@@ -62,6 +67,18 @@ public:
 		return TotalSize;
 	}
 
+	// Gives access to the child enumerators before enumeration starts, in case they need adjusting
+	template < typename TFunc >
+	void ForEachChild(TFunc Func)
+	{
+		TotalSize = 0;
+		for(auto& Child : ChildEnumList)
+		{
+			Func(*Child);
+			TotalSize += Child->EstimatedSize();
+		}
+	}
+
 protected:
 	void Prepass(TArray< FName > const& Names)
 	{
@@ -75,7 +92,7 @@ protected:
 	}
 
 protected:
-	TArray< TUniquePtr< ISourceObjectEnumerator > > ChildEnumList;
+	TArray< TUniquePtr< TChildEnum > > ChildEnumList;
 	int32 CurEnumIndex;
 	int32 TotalSize;
 	int32 Completed;
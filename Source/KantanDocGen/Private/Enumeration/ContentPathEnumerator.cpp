@@ -10,11 +10,23 @@
 #include "ARFilter.h"
 #include "Engine/Blueprint.h"
 #include "Animation/AnimBlueprint.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ContentPathEnumerator
+{
+	// Number of blueprints loaded in the background ahead of the one being enumerated
+	static const int32 PrefetchWindow = 8;
+}
 
 
 FContentPathEnumerator::FContentPathEnumerator(
 	FName const& InPath
 )
+	: PrefetchCompleted(MakeShared< TSet< FName > >())
 {
 	CurIndex = 0;
 
@@ -58,9 +70,82 @@ UObject* FContentPathEnumerator::GetNext()
 	return Result;
 }
 
+FString FContentPathEnumerator::GetPackageSignature(FAssetData const& AssetData)
+{
+	auto& AssetRegistryModule = FModuleManager::GetModuleChecked< FAssetRegistryModule >("AssetRegistry");
+	auto& AssetRegistry = AssetRegistryModule.Get();
+
+	FString Signature;
+#if UE_VERSION_OLDER_THAN(5, 1, 0)
+	if(auto PackageData = AssetRegistry.GetAssetPackageData(AssetData.PackageName))
+	{
+		Signature = FString::Printf(TEXT("%s_%lld"), *PackageData->PackageGuid.ToString(), PackageData->DiskSize);
+	}
+#else
+	TOptional< FAssetPackageData > PackageData = AssetRegistry.GetAssetPackageDataCopy(AssetData.PackageName);
+	if(PackageData.IsSet())
+	{
+		Signature = FString::Printf(TEXT("%s_%lld"),
+			*LexToString(PackageData->GetPackageSavedHash()), PackageData->DiskSize);
+	}
+#endif
+
+	// The registry doesn't always have package data, so also go by the file itself
+	FString Filename;
+	if(FPackageName::DoesPackageExist(AssetData.PackageName.ToString(), nullptr, &Filename))
+	{
+		FFileStatData const Stat = IFileManager::Get().GetStatData(*Filename);
+		if(Stat.bIsValid)
+		{
+			Signature += FString::Printf(TEXT("_%lld_%lld"), Stat.FileSize, Stat.ModificationTime.GetTicks());
+		}
+	}
+	return Signature;
+}
+
+int32 FContentPathEnumerator::RemoveAssets(TFunctionRef< bool(FAssetData const&) > Predicate)
+{
+	check(CurIndex == 0);
+	return AssetList.RemoveAll(Predicate);
+}
+
+bool FContentPathEnumerator::IsNextReady()
+{
+	// A commandlet has no frames to keep responsive, so just load on demand
+	if(IsRunningCommandlet() || CurIndex >= AssetList.Num())
+	{
+		return true;
+	}
+
+	// Start loading the next few packages, so GetNext doesn't have to stall the game thread on them
+	int32 const WindowEnd = FMath::Min(CurIndex + ContentPathEnumerator::PrefetchWindow, AssetList.Num());
+	for(int32 Index = CurIndex; Index < WindowEnd; ++Index)
+	{
+		auto const& AssetData = AssetList[Index];
+		if(!AssetData.IsAssetLoaded() && !PrefetchRequested.Contains(AssetData.PackageName))
+		{
+			PrefetchRequested.Add(AssetData.PackageName);
+			TWeakPtr< TSet< FName > > WeakCompleted = PrefetchCompleted;
+			LoadPackageAsync(AssetData.PackageName.ToString(), FLoadPackageAsyncDelegate::CreateLambda(
+				[WeakCompleted](FName const& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+				{
+					if(auto Completed = WeakCompleted.Pin())
+					{
+						Completed->Add(PackageName);
+					}
+				}));
+		}
+	}
+
+	auto const& Next = AssetList[CurIndex];
+	return Next.IsAssetLoaded()
+		|| !PrefetchRequested.Contains(Next.PackageName)
+		|| PrefetchCompleted->Contains(Next.PackageName);
+}
+
 float FContentPathEnumerator::EstimateProgress() const
 {
-	return (float)CurIndex / (AssetList.Num() - 1);
+	return AssetList.Num() > 0 ? (float)CurIndex / AssetList.Num() : 1.0f;
 }
 
 int32 FContentPathEnumerator::EstimatedSize() const
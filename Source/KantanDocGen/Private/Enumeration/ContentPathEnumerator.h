@@ -19,15 +19,26 @@ public:
 
 public:
 	virtual UObject* GetNext() override;
+	virtual bool IsNextReady() override;
 	virtual float EstimateProgress() const override;
 	virtual int32 EstimatedSize() const override;
 
+public:
+	/** Signature of an asset's package, which changes whenever the package is saved. Empty if unknown. */
+	static FString GetPackageSignature(FAssetData const& AssetData);
+	/** Drops the assets Predicate returns true for. Only before enumeration has started. */
+	int32 RemoveAssets(TFunctionRef< bool(FAssetData const&) > Predicate);
+
 protected:
 	void Prepass(FName const& Path);
 
 protected:
 	TArray< FAssetData > AssetList;
 	int32 CurIndex;
+
+	// Packages requested ahead of the enumeration, and those whose load has finished (successfully or not)
+	TSet< FName > PrefetchRequested;
+	TSharedRef< TSet< FName > > PrefetchCompleted;
 };
 
 
@@ -15,6 +15,8 @@ class ISourceObjectEnumerator
 {
 public:
 	virtual UObject* GetNext() = 0;
+	// False while GetNext would have to block, for example on a load it has started in the background
+	virtual bool IsNextReady() { return true; }
 	virtual float EstimateProgress() const = 0;
 	virtual int32 EstimatedSize() const = 0;
 
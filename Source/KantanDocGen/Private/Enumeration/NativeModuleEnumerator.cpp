@@ -6,10 +6,53 @@
 
 #include "NativeModuleEnumerator.h"
 #include "KantanDocGenLog.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/SecureHash.h"
+#include "UObject/MetaData.h"
 #include "UObject/Package.h"
 #include "UObject/UObjectHash.h"
 #include "UObject/UnrealType.h"
 
+namespace NativeModuleEnumerator
+{
+	void AppendMetaData(TMap< FName, FString > const* MetaData, TArray< FString >& Parts)
+	{
+		if(MetaData == nullptr)
+		{
+			return;
+		}
+		// Map order isn't stable between sessions
+		TArray< FString > Entries;
+		for(auto const& Entry : *MetaData)
+		{
+			Entries.Add(Entry.Key.ToString() + TEXT("=") + Entry.Value);
+		}
+		Entries.Sort();
+		Parts.Append(Entries);
+	}
+
+	void AppendObjectMetaData(UObject const* Object, TArray< FString >& Parts)
+	{
+#if UE_VERSION_OLDER_THAN(5, 6, 0)
+		AppendMetaData(UMetaData::GetMapForObject(Object), Parts);
+#else
+		AppendMetaData(FMetaData::GetMapForObject(Object), Parts);
+#endif
+	}
+
+	void AppendProperty(FProperty const* Property, TArray< FString >& Parts)
+	{
+		FString ExtendedType;
+		FString const Type = Property->GetCPPType(&ExtendedType);
+		Parts.Add(FString::Printf(TEXT("P %s %s%s %llu"), *Property->GetName(), *Type, *ExtendedType,
+			(uint64)Property->PropertyFlags));
+#if WITH_METADATA
+		AppendMetaData(Property->GetMetaDataMap(), Parts);
+#endif
+	}
+}
+
 FNativeModuleEnumerator::FNativeModuleEnumerator(FName const& InModuleName)
 {
 	CurIndex = 0;
@@ -24,6 +67,7 @@ void FNativeModuleEnumerator::Prepass(FName const& ModuleName)
 
 	// Attempt to find the package
 	auto PkgName = TEXT("/Script/") + ModuleName.ToString();
+	PackageName = FName(*PkgName);
 
 	auto Package = FindPackage(nullptr, *PkgName);
 	if (Package == nullptr)
@@ -98,10 +142,81 @@ UObject* FNativeModuleEnumerator::GetNext()
 
 float FNativeModuleEnumerator::EstimateProgress() const
 {
-	return (float) CurIndex / (ObjectList.Num() - 1);
+	return ObjectList.Num() > 0 ? (float) CurIndex / ObjectList.Num() : 1.0f;
 }
 
 int32 FNativeModuleEnumerator::EstimatedSize() const
 {
 	return ObjectList.Num();
 }
+
+FName FNativeModuleEnumerator::GetPackageName() const
+{
+	return PackageName;
+}
+
+FString FNativeModuleEnumerator::GetSignature() const
+{
+	using namespace NativeModuleEnumerator;
+
+	// Node docs also depend on the node classes themselves, which only change with the engine
+	TArray< FString > Parts;
+	Parts.Add(FEngineVersion::Current().ToString(EVersionComponent::Changelist));
+	for(auto const& WeakObject : ObjectList)
+	{
+		UObject const* Object = WeakObject.Get();
+		if(Object == nullptr)
+		{
+			continue;
+		}
+		Parts.Add(Object->GetPathName());
+		AppendObjectMetaData(Object, Parts);
+
+		if(auto Enum = Cast< UEnum >(Object))
+		{
+			for(int32 Index = 0; Index < Enum->NumEnums(); ++Index)
+			{
+				Parts.Add(FString::Printf(TEXT("E %s %lld"), *Enum->GetNameStringByIndex(Index),
+					Enum->GetValueByIndex(Index)));
+			}
+			continue;
+		}
+
+		auto Struct = Cast< UStruct >(Object);
+		if(Struct == nullptr)
+		{
+			continue;
+		}
+		Parts.Add(GetPathNameSafe(Struct->GetSuperStruct()));
+		if(auto Class = Cast< UClass >(Struct))
+		{
+			Parts.Add(FString::Printf(TEXT("C %u"), (uint32)Class->ClassFlags));
+			for(TFieldIterator< UFunction > FuncIt(Class, EFieldIteratorFlags::ExcludeSuper); FuncIt; ++FuncIt)
+			{
+				Parts.Add(FString::Printf(TEXT("F %s %u"), *FuncIt->GetName(), (uint32)FuncIt->FunctionFlags));
+				AppendObjectMetaData(*FuncIt, Parts);
+				for(TFieldIterator< FProperty > ParamIt(*FuncIt); ParamIt; ++ParamIt)
+				{
+					AppendProperty(*ParamIt, Parts);
+				}
+			}
+		}
+		for(TFieldIterator< FProperty > PropIt(Struct, EFieldIteratorFlags::ExcludeSuper); PropIt; ++PropIt)
+		{
+			AppendProperty(*PropIt, Parts);
+		}
+	}
+
+	FTCHARToUTF8 Utf8(*FString::Join(Parts, TEXT("\n")));
+	FMD5 Md5;
+	Md5.Update((uint8 const*)Utf8.Get(), Utf8.Length());
+	uint8 Digest[16];
+	Md5.Final(Digest);
+	return BytesToHex(Digest, 16);
+}
+
+void FNativeModuleEnumerator::RemoveAll()
+{
+	ObjectList.Reset();
+	CurIndex = 0;
+}
@@ -21,10 +21,22 @@ public:
 	virtual float EstimateProgress() const override;
 	virtual int32 EstimatedSize() const override;
 
+public:
+	/** The module's script package, which its objects are recorded under in the manifest */
+	FName GetPackageName() const;
+	/**
+	 * Hash of the reflection data the module's docs are made from: its types, functions and properties, with their
+	 * flags and metadata. Changes when a code change to the module affects anything it documents.
+	 */
+	FString GetSignature() const;
+	/** Drops every object of the module. Only before enumeration has started. */
+	void RemoveAll();
+
 protected:
 	void Prepass(FName const& ModuleName);
 
 protected:
+	FName PackageName;
 	TArray< TWeakObjectPtr< UObject > > ObjectList;
 	int32 CurIndex;
 };
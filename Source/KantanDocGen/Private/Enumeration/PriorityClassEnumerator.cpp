@@ -0,0 +1,114 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#include "PriorityClassEnumerator.h"
+#include "KantanDocGenLog.h"
+#include "AssetRegistryModule.h"
+#include "ARFilter.h"
+#include "Engine/Blueprint.h"
+#include "Animation/AnimBlueprint.h"
+#include "UObject/Package.h"
+
+
+FPriorityClassEnumerator::FPriorityClassEnumerator(
+	TArray< FName > const& InClassNames,
+	TArray< FName > const& InNativeModules,
+	TArray< FName > const& InContentPaths
+)
+{
+	CurIndex = 0;
+
+	Prepass(InClassNames, InNativeModules, InContentPaths);
+}
+
+void FPriorityClassEnumerator::Prepass(TArray< FName > const& ClassNames, TArray< FName > const& NativeModules, TArray< FName > const& ContentPaths)
+{
+	if(ClassNames.Num() == 0)
+	{
+		return;
+	}
+
+	// Blueprints may be named by their generated class
+	TSet< FString > Remaining;
+	for(auto const& Name : ClassNames)
+	{
+		FString NameString = Name.ToString();
+		NameString.RemoveFromEnd(TEXT("_C"));
+		Remaining.Add(NameString);
+	}
+
+	for(auto const& ModuleName : NativeModules)
+	{
+		auto PkgName = TEXT("/Script/") + ModuleName.ToString();
+		auto Package = FindPackage(nullptr, *PkgName);
+		if(Package == nullptr)
+		{
+			continue;
+		}
+
+		for(auto It = Remaining.CreateIterator(); It; ++It)
+		{
+			// Classes, structs and enums, as enumerated for the module
+			if(auto Field = FindObject< UField >(Package, **It))
+			{
+				ObjectList.Add(FSoftObjectPath(Field));
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	if(Remaining.Num() > 0 && ContentPaths.Num() > 0)
+	{
+		auto& AssetRegistryModule = FModuleManager::GetModuleChecked< FAssetRegistryModule >("AssetRegistry");
+		auto& AssetRegistry = AssetRegistryModule.Get();
+
+		FARFilter Filter;
+		Filter.bRecursivePaths = true;
+		Filter.bRecursiveClasses = true;
+		Filter.PackagePaths = ContentPaths;
+		Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+		// Matching FContentPathEnumerator, which never enumerates anim blueprints
+		Filter.RecursiveClassesExclusionSet.Add(UAnimBlueprint::StaticClass()->GetFName());
+
+		TArray< FAssetData > AssetList;
+		AssetRegistry.GetAssets(Filter, AssetList);
+		for(auto const& AssetData : AssetList)
+		{
+			if(Remaining.Remove(AssetData.AssetName.ToString()) > 0)
+			{
+				ObjectList.Add(AssetData.ToSoftObjectPath());
+			}
+		}
+	}
+
+	for(auto const& Name : Remaining)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Priority class '%s' is not in any of the modules or paths being documented, ignoring."), *Name);
+	}
+}
+
+UObject* FPriorityClassEnumerator::GetNext()
+{
+	UObject* Result = nullptr;
+
+	while(Result == nullptr && CurIndex < ObjectList.Num())
+	{
+		Result = ObjectList[CurIndex].TryLoad();
+		++CurIndex;
+	}
+
+	return Result;
+}
+
+float FPriorityClassEnumerator::EstimateProgress() const
+{
+	return ObjectList.Num() > 0 ? (float)CurIndex / ObjectList.Num() : 1.0f;
+}
+
+int32 FPriorityClassEnumerator::EstimatedSize() const
+{
+	return ObjectList.Num();
+}
@@ -0,0 +1,39 @@
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Copyright (C) 2016-2017 Cameron Angus. All Rights Reserved.
+
+#pragma once
+
+#include "ISourceObjectEnumerator.h"
+#include "UObject/SoftObjectPath.h"
+
+
+/*
+Enumerates the named classes and blueprints found within the given modules and content paths, so that they can be
+documented ahead of everything else. Names outside of those are ignored, as they would not otherwise be documented.
+*/
+class FPriorityClassEnumerator: public ISourceObjectEnumerator
+{
+public:
+	FPriorityClassEnumerator(
+		TArray< FName > const& InClassNames,
+		TArray< FName > const& InNativeModules,
+		TArray< FName > const& InContentPaths
+	);
+
+public:
+	virtual UObject* GetNext() override;
+	virtual float EstimateProgress() const override;
+	virtual int32 EstimatedSize() const override;
+
+protected:
+	void Prepass(TArray< FName > const& ClassNames, TArray< FName > const& NativeModules, TArray< FName > const& ContentPaths);
+
+protected:
+	TArray< FSoftObjectPath > ObjectList;
+	int32 CurIndex;
+};
+
+
@@ -13,13 +13,32 @@
 #include "ISettingsModule.h"
 #include "ISettingsSection.h"
 
+#include "Animation/AnimBlueprint.h"
 #include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
 #include "HAL/RunnableThread.h"
 #include "Interfaces/IMainFrameModule.h"
 #include "LevelEditor.h"
+#include "Misc/PackageName.h"
+#include "TimerManager.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+#include "Misc/HotReloadInterface.h"
+#else
+#include "UObject/ObjectSaveContext.h"
+#endif
+#if WITH_LIVE_CODING
+#include "ILiveCodingModule.h"
+#endif
 
 #define LOCTEXT_NAMESPACE "KantanDocGen"
 
@@ -55,6 +74,11 @@ void FKantanDocGenModule::StartupModule()
 
 		RegisterSettings();
 	}
+
+	if (GIsEditor && !IsRunningCommandlet())
+	{
+		StartWatching();
+	}
 }
 
 void FKantanDocGenModule::RegisterSettings()
@@ -91,10 +115,160 @@ void FKantanDocGenModule::UnregisterSettings()
 
 void FKantanDocGenModule::ShutdownModule()
 {
+	if (Processor.IsValid())
+	{
+		// Cancel any run in progress, servicing its game thread requests until it has wound down
+		Processor->Stop();
+		double const Deadline = FPlatformTime::Seconds() + 5.0;
+		while (Processor->IsRunning() && FPlatformTime::Seconds() < Deadline)
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.01f);
+		}
+	}
+
+	StopWatching();
 	FKantanDocGenCommands::Unregister();
 	UnregisterSettings();
 }
 
+void FKantanDocGenModule::StartWatching()
+{
+	// Always subscribed, so that watch mode can be switched on and off in the settings without a restart
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	PackageSavedHandle = UPackage::PackageSavedEvent.AddLambda([this](FString const& PackageFileName, UObject* Outer) {
+		OnPackageSaved(PackageFileName, Cast<UPackage>(Outer));
+	});
+	if (IHotReloadInterface* HotReload = IHotReloadInterface::GetPtr())
+	{
+		CodeReloadedHandle = HotReload->OnHotReload().AddLambda([this](bool) { OnCodeReloaded(); });
+	}
+#else
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddLambda(
+		[this](FString const& PackageFileName, UPackage* Package, FObjectPostSaveContext) {
+			OnPackageSaved(PackageFileName, Package);
+		});
+	CodeReloadedHandle =
+		FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([this](EReloadCompleteReason) { OnCodeReloaded(); });
+#endif
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::LoadModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCodingPatchHandle =
+			LiveCoding->GetOnPatchCompleteDelegate().AddRaw(this, &FKantanDocGenModule::OnCodeReloaded);
+	}
+#endif
+}
+
+void FKantanDocGenModule::StopWatching()
+{
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	UPackage::PackageSavedEvent.Remove(PackageSavedHandle);
+	if (IHotReloadInterface* HotReload = IHotReloadInterface::GetPtr())
+	{
+		HotReload->OnHotReload().Remove(CodeReloadedHandle);
+	}
+#else
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(CodeReloadedHandle);
+#endif
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCoding->GetOnPatchCompleteDelegate().Remove(LiveCodingPatchHandle);
+	}
+#endif
+
+	if (GEditor && WatchTimer.IsValid())
+	{
+		GEditor->GetTimerManager()->ClearTimer(WatchTimer);
+	}
+}
+
+void FKantanDocGenModule::OnPackageSaved(FString const& PackageFileName, UPackage* Package)
+{
+	auto const Settings = UKantanDocGenSettingsObject::Get();
+	if (!Settings->bWatchForChanges || Package == nullptr)
+	{
+		return;
+	}
+
+	// Only blueprints the content enumerators would document; anything else saved has no docs to update
+	FString const PackageName = Package->GetName();
+	bool bInScope = false;
+	for (auto const& Path : Settings->Settings.ContentPaths)
+	{
+		FString PathString = Path.Path;
+		PathString.RemoveFromEnd(TEXT("/"));
+		bInScope |= PackageName.StartsWith(PathString + TEXT("/"));
+	}
+	auto Blueprint = FindObject<UBlueprint>(Package, *FPackageName::GetShortName(PackageName));
+	if (!bInScope || Blueprint == nullptr || Blueprint->IsA<UAnimBlueprint>())
+	{
+		return;
+	}
+
+	bWatchContentChanged = true;
+	ScheduleWatchRun();
+}
+
+void FKantanDocGenModule::OnCodeReloaded()
+{
+	auto const Settings = UKantanDocGenSettingsObject::Get();
+	if (!Settings->bWatchForChanges || Settings->Settings.NativeModules.Num() == 0)
+	{
+		return;
+	}
+
+	// Which modules were reloaded isn't reported, so the run tells them apart by the signature of their reflection data
+	bWatchCodeChanged = true;
+	ScheduleWatchRun();
+}
+
+void FKantanDocGenModule::ScheduleWatchRun()
+{
+	if (GEditor == nullptr)
+	{
+		return;
+	}
+
+	float const Delay = FMath::Max(UKantanDocGenSettingsObject::Get()->WatchDelaySeconds, 0.01f);
+	GEditor->GetTimerManager()->SetTimer(
+		WatchTimer, FTimerDelegate::CreateRaw(this, &FKantanDocGenModule::RunWatchTask), Delay, false);
+}
+
+void FKantanDocGenModule::RunWatchTask()
+{
+	// Changes made while a run is in progress are picked up by the next one, once it has finished
+	if (IsProcessorRunning())
+	{
+		ScheduleWatchRun();
+		return;
+	}
+
+	FKantanDocGenSettings Settings = UKantanDocGenSettingsObject::Get()->Settings;
+	if (!Settings.HasAnySources() || Settings.BlueprintContextClass == nullptr)
+	{
+		return;
+	}
+
+	TCHAR const* Changed = bWatchCodeChanged ? TEXT("reloaded code") : TEXT("saved blueprints");
+	if (bWatchContentChanged && bWatchCodeChanged)
+	{
+		Changed = TEXT("saved blueprints and reloaded code");
+	}
+	UE_LOG(LogKantanDocGen, Display, TEXT("Watch mode: regenerating docs for %s"), Changed);
+
+	// An incremental run carries forward every content package not saved and every module not changed since the last
+	// run, so it only loads and spawns the nodes of what was saved or reloaded
+	Settings.bIncremental = true;
+	Settings.bCleanOutputDirectory = false;
+	bWatchContentChanged = false;
+	bWatchCodeChanged = false;
+
+	GenerateDocs(Settings);
+}
+
 // @TODO: Idea was to allow quoted values containing spaces, but this isn't possible since the initial console string
 // has already been split by whitespace, ignoring quotes...
 inline bool MatchPotentiallyQuoted(const TCHAR* Stream, const TCHAR* Match, FString& Value)
@@ -126,7 +300,7 @@ TFuture<void> FKantanDocGenModule::GenerateDocs(FKantanDocGenSettings const& Set
 
 	Processor->QueueTask(Settings);
 
-	if (!Processor->IsRunning())
+	if (Processor->TryStartRunning())
 	{
 		return Async(EAsyncExecution::Thread, [Processor = Processor.Get()]() { Processor->Run(); });
 		// FRunnableThread::Create(Processor.Get(), TEXT("KantanDocGenProcessorThread"), 0, TPri_BelowNormal);
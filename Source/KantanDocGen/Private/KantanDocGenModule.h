@@ -7,9 +7,12 @@
 #pragma once
 
 #include "DocGenTaskProcessor.h" // TUniquePtr seems to need full definition...
+#include "Engine/EngineTypes.h"
+#include "Misc/EngineVersionComparison.h"
 #include "Modules/ModuleManager.h"
 
 class FUICommandList;
+class UPackage;
 
 /*
 Module implementation
@@ -39,8 +42,28 @@ protected:
 								 bool bCleanOutput);
 	void ShowDocGenUI();
 
+	// Watch mode, editor only
+	void StartWatching();
+	void StopWatching();
+	void OnPackageSaved(FString const& PackageFileName, UPackage* Package);
+	void OnCodeReloaded();
+	/** (Re)starts the delay before the changes seen so far are documented */
+	void ScheduleWatchRun();
+	void RunWatchTask();
+
 protected:
 	TUniquePtr<FDocGenTaskProcessor> Processor;
 
 	TSharedPtr<FUICommandList> UICommands;
+
+	// Set when a documented blueprint has been saved since the last watch run
+	bool bWatchContentChanged = false;
+	// Set when code has been reloaded since the last watch run
+	bool bWatchCodeChanged = false;
+	FTimerHandle WatchTimer;
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle CodeReloadedHandle;
+#if WITH_LIVE_CODING
+	FDelegateHandle LiveCodingPatchHandle;
+#endif
 };
@@ -6,23 +6,34 @@
 
 #include "NodeDocsGenerator.h"
 #include "Async/Async.h"
+#include "AssetRegistryModule.h"
 #include "BlueprintActionDatabase.h"
 #include "BlueprintBoundNodeSpawner.h"
 #include "BlueprintComponentNodeSpawner.h"
 #include "BlueprintEventNodeSpawner.h"
 #include "BlueprintFunctionNodeSpawner.h"
 #include "BlueprintNodeSpawner.h"
+#include "DocGenDerivedData.h"
+#include "DocGenImageCache.h"
+#include "DocGenManifest.h"
 #include "DocTreeNode.h"
 #include "DoxygenParserHelpers.h"
 #include "EdGraphSchema_K2.h"
+#include "Enumeration/ContentPathEnumerator.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "HAL/FileManager.h"
 #include "HighResScreenshot.h"
 #include "K2Node_DynamicCast.h"
 #include "K2Node_Message.h"
 #include "KantanDocGenLog.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/EngineVersion.h"
 #include "Misc/EngineVersionComparison.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 #include "NodeFactory.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 #include "Runtime/ImageWriteQueue/Public/ImageWriteTask.h"
@@ -30,9 +41,61 @@
 #include "SGraphPanel.h"
 #include "Slate/WidgetRenderer.h"
 #include "Stats/StatsMisc.h"
+#include "Widgets/SCanvas.h"
 #include "TextureResource.h"
 #include "ThreadingHelpers.h"
 
+namespace NodeDocsGenerator
+{
+	// Nodes spawned into one dummy graph before moving on to a fresh one
+	static const int32 NodesPerGraph = 256;
+	// Size of the render target node widgets are drawn into
+	static const FVector2D ImageDrawSize(1024.0f, 1024.0f);
+	// Node images are drawn side by side into atlases this wide, each only as tall as its nodes need
+	static const int32 AtlasWidth = 2048;
+	static const int32 AtlasMaxHeight = 2048;
+	// Left between nodes in an atlas, so nothing a widget draws past its bounds ends up in another's image
+	static const int32 AtlasPadding = 4;
+	// Kinds of artifact kept in the derived data cache
+	static const TCHAR* NodeImageKind = TEXT("NodeImage");
+	static const TCHAR* NodeDocKind = TEXT("NodeDoc");
+	static const TCHAR* TypeDocKind = TEXT("TypeDoc");
+
+	static FString FinishHash(FMD5& Md5)
+	{
+		uint8 Digest[16];
+		Md5.Final(Digest);
+		return BytesToHex(Digest, sizeof(Digest));
+	}
+
+	static void AppendDoxygenTags(TSharedPtr<DocTreeNode> const& Element, Detail::FDoxygenTags const& Tags)
+	{
+		if (!Tags.IsEmpty())
+		{
+			auto DoxygenElement = Element->AppendChild("doxygen");
+			Tags.ForEachTag([&DoxygenElement](FStringView Name, FStringView Value) {
+				DoxygenElement->AppendChildWithValueEscaped(FString(Name.Len(), Name.GetData()),
+															FString(Value.Len(), Value.GetData()));
+			});
+		}
+	}
+}
+
+void FNodeDocsGenerator::SetManifest(FDocGenManifest* InManifest)
+{
+	Manifest = InManifest;
+}
+
+void FNodeDocsGenerator::SetImageCache(FDocGenImageCache* InImageCache)
+{
+	ImageCache = InImageCache;
+}
+
+void FNodeDocsGenerator::SetDerivedData(FDocGenDerivedData* InDerivedData)
+{
+	DerivedData = InDerivedData;
+}
+
 FNodeDocsGenerator::~FNodeDocsGenerator()
 {
 	CleanUp();
@@ -48,15 +111,12 @@ bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOu
 		return false;
 	}
 
-	Graph = FBlueprintEditorUtils::CreateNewGraph(DummyBP.Get(), TEXT("TempoGraph"), UEdGraph::StaticClass(),
-												  UEdGraphSchema_K2::StaticClass());
-
 	DummyBP->AddToRoot();
-	Graph->AddToRoot();
 
-	GraphPanel = SNew(SGraphPanel).GraphObj(Graph.Get());
-	// We want full detail for rendering, passing a super-high zoom value will guarantee the highest LOD.
-	GraphPanel->RestoreViewSettings(FVector2D(0, 0), 10.0f);
+	if (!GT_CreateGraph())
+	{
+		return false;
+	}
 
 	DocsTitle = InDocsTitle;
 
@@ -68,16 +128,128 @@ bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOu
 	return true;
 }
 
+bool FNodeDocsGenerator::GT_ShouldSpawn(UBlueprintNodeSpawner* Spawner, UObject* SourceObject)
+{
+	if (!IsSpawnerDocumentable(Spawner, SourceObject->IsA<UBlueprint>()))
+	{
+		return false;
+	}
+
+	// A function node is associated with the function's owning class and takes the function's name as its doc id, so
+	// an inherited function reached again from a subclass can be recognised without spawning it
+	if (auto FuncSpawner = Cast<UBlueprintFunctionNodeSpawner>(Spawner))
+	{
+		UFunction const* Function = FuncSpawner->GetFunction();
+		UClass* OwnerClass = Function ? Function->GetOwnerClass() : nullptr;
+		if (OwnerClass && SpawnedNodeKeys.Contains(MakeNodeKey(GetClassDocId(OwnerClass), Function->GetName())))
+		{
+			++DuplicateNodesSkipped;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FNodeDocsGenerator::GT_CreateGraph()
+{
+	FName const GraphName = MakeUniqueObjectName(DummyBP.Get(), UEdGraph::StaticClass(), TEXT("TempoGraph"));
+	Graph = FBlueprintEditorUtils::CreateNewGraph(DummyBP.Get(), GraphName, UEdGraph::StaticClass(),
+												  UEdGraphSchema_K2::StaticClass());
+	if (!Graph.IsValid())
+	{
+		return false;
+	}
+	Graph->AddToRoot();
+	// Tracked from the start, so that the graph is destroyed even if no node spawned into it is kept
+	LiveNodesPerGraph.Add(Graph, 0);
+	NodesSpawnedIntoGraph = 0;
+	++GraphsUsed;
+
+	GraphPanel = SNew(SGraphPanel).GraphObj(Graph.Get());
+	// We want full detail for rendering, passing a super-high zoom value will guarantee the highest LOD.
+	GraphPanel->RestoreViewSettings(FVector2D(0, 0), 10.0f);
+	return true;
+}
+
+void FNodeDocsGenerator::GT_DestroyGraph(UEdGraph* OldGraph)
+{
+	OldGraph->RemoveFromRoot();
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	OldGraph->MarkPendingKill();
+#else
+	OldGraph->MarkAsGarbage();
+#endif
+}
+
+void FNodeDocsGenerator::GT_DestroyNode(UEdGraphNode* Node)
+{
+	if (auto NodeGraph = Node->GetGraph())
+	{
+		NodeGraph->RemoveNode(Node);
+	}
+	Node->RemoveFromRoot();
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	Node->MarkPendingKill();
+#else
+	Node->MarkAsGarbage();
+#endif
+}
+
+FNodeDocsGenerator::FNodeLease::FNodeLease(FNodeDocsGenerator& InOwner, UK2Node* InNode)
+	: Owner(InOwner)
+	, Node(InNode)
+{}
+
+FNodeDocsGenerator::FNodeLease::~FNodeLease()
+{
+	Owner.RetireNode(Node);
+}
+
+void FNodeDocsGenerator::RetireNode(UK2Node* Node)
+{
+	RetiredNodes.Enqueue(Node);
+}
+
+void FNodeDocsGenerator::GT_ReleaseRetiredNodes()
+{
+	UK2Node* Node = nullptr;
+	while (RetiredNodes.Dequeue(Node))
+	{
+		if (int32* LiveNodes = LiveNodesPerGraph.Find(Node->GetGraph()))
+		{
+			--*LiveNodes;
+		}
+		GT_DestroyNode(Node);
+	}
+
+	for (auto It = LiveNodesPerGraph.CreateIterator(); It; ++It)
+	{
+		if (It.Key() != Graph && It.Value() <= 0)
+		{
+			if (UEdGraph* OldGraph = It.Key().Get())
+			{
+				GT_DestroyGraph(OldGraph);
+			}
+			It.RemoveCurrent();
+		}
+	}
+}
+
 UK2Node* FNodeDocsGenerator::GT_InitializeForSpawner(UBlueprintNodeSpawner* Spawner, UObject* SourceObject,
 													 FNodeProcessingState& OutState)
 {
-	if (!IsSpawnerDocumentable(Spawner, SourceObject->IsA<UBlueprint>()))
+	// Move on to a fresh graph every so often, so that no one graph collects an unbounded number of nodes
+	if (NodesSpawnedIntoGraph >= NodeDocsGenerator::NodesPerGraph)
 	{
-		return nullptr;
+		if (!GT_CreateGraph())
+		{
+			return nullptr;
+		}
 	}
 
 	// Spawn an instance into the graph
 	auto NodeInst = Spawner->Invoke(Graph.Get(), IBlueprintNodeBinder::FBindingSet {}, FVector2D(0, 0));
+	++NodesSpawnedIntoGraph;
 
 	// Currently Blueprint nodes only
 	auto K2NodeInst = Cast<UK2Node>(NodeInst);
@@ -86,26 +258,218 @@ UK2Node* FNodeDocsGenerator::GT_InitializeForSpawner(UBlueprintNodeSpawner* Spaw
 	{
 		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to create node from spawner of class %s with node class %s."),
 			   *Spawner->GetClass()->GetName(), Spawner->NodeClass ? *Spawner->NodeClass->GetName() : TEXT("None"));
+		if (NodeInst)
+		{
+			GT_DestroyNode(NodeInst);
+		}
 		return nullptr;
 	}
 
 	auto AssociatedClass = MapToAssociatedClass(K2NodeInst, SourceObject);
+	if (AssociatedClass == nullptr)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to find class associated with node %s."),
+			   *K2NodeInst->GetName());
+		GT_DestroyNode(K2NodeInst);
+		return nullptr;
+	}
 
-	if (!ClassDocTreeMap.Contains(AssociatedClass))
+	FString const ClassId = GetClassDocId(AssociatedClass);
+	FString const NodeId = GetNodeDocId(K2NodeInst);
+	SpawnedNodeKeys.Add(MakeNodeKey(ClassId, NodeId));
+	FString const ClassDisplayName = GetClassDisplayName(AssociatedClass);
 	{
-		ClassDocTreeMap.Add(AssociatedClass, InitClassDocTree(AssociatedClass));
-		UpdateIndexDocWithClass(IndexTree, AssociatedClass);
+		FScopeLock Lock(&DocTreeLock);
+		// Each node is documented once per run, however many source objects lead to it
+		bool bAlreadyDocumented = false;
+		DocumentedNodeKeys.Add(MakeNodeKey(ClassId, NodeId), &bAlreadyDocumented);
+		if (bAlreadyDocumented)
+		{
+			++DuplicateNodesSkipped;
+			GT_DestroyNode(K2NodeInst);
+			return nullptr;
+		}
+
+		OutState = FNodeProcessingState();
+		OutState.ClassDocsPath = OutputDir / ClassId;
+		OutState.ClassDocTree = FindOrAddClassDocTree(ClassId, ClassDisplayName);
 	}
 
-	OutState = FNodeProcessingState();
-	OutState.ClassDocsPath = OutputDir / GetClassDocId(AssociatedClass);
-	OutState.ClassDocTree = ClassDocTreeMap.FindChecked(AssociatedClass);
+	// Read once, for the node hash, the doc body, the image file name and the class doc listing
+	OutState.Snapshot.ClassId = ClassId;
+	OutState.Snapshot.ClassDisplayName = ClassDisplayName;
+	OutState.Snapshot.NodeId = NodeId;
+	GT_SnapshotNode(K2NodeInst, OutState.Snapshot);
+	// Keys the node in the manifest and the derived data cache, whether or not the node goes on to be documented
+	if (Manifest || DerivedData)
+	{
+		OutState.NodeHash = GT_HashNode(K2NodeInst, OutState.Snapshot);
+	}
 
+	// Released through an FNodeLease once the pipeline is done with it
+	++LiveNodesPerGraph.FindOrAdd(Graph);
 	return K2NodeInst;
 }
 
-bool FNodeDocsGenerator::GT_Finalize(FString OutputPath)
+void FNodeDocsGenerator::GT_DiscardSpawnedNode(UK2Node* Node, FNodeProcessingState const& State)
+{
+	{
+		FScopeLock Lock(&DocTreeLock);
+		DocumentedNodeKeys.Remove(MakeNodeKey(State.Snapshot.ClassId, State.Snapshot.NodeId));
+	}
+	RetireNode(Node);
+}
+
+bool FNodeDocsGenerator::GT_CheckUnchanged(FNodeProcessingState const& State, FDocumentedNode& OutNode)
 {
+	if (Manifest == nullptr || State.NodeHash.IsEmpty())
+	{
+		return false;
+	}
+
+	FNodeSnapshot const& Snapshot = State.Snapshot;
+	FString const NodeKey = MakeNodeKey(Snapshot.ClassId, Snapshot.NodeId);
+	if (!Manifest->IsNodeUnchanged(NodeKey, State.NodeHash))
+	{
+		return false;
+	}
+	Manifest->RecordNode(NodeKey, State.NodeHash);
+
+	OutNode = FDocumentedNode();
+	OutNode.ClassId = Snapshot.ClassId;
+	OutNode.ClassDisplayName = Snapshot.ClassDisplayName;
+	OutNode.NodeId = Snapshot.NodeId;
+	OutNode.ShortTitle = Snapshot.ShortTitle;
+	OutNode.ImageFile =
+		State.ClassDocsPath / TEXT("img") / FString::Printf(TEXT("nd_img_%s.png"), *Snapshot.NodeId);
+
+	FScopeLock Lock(&DocTreeLock);
+	return UpdateClassDocWithNode(State.ClassDocTree, Snapshot.NodeId, OutNode.ShortTitle);
+}
+
+FString FNodeDocsGenerator::GT_HashNode(UK2Node* Node, FNodeSnapshot const& Snapshot)
+{
+	// Everything the node's doc file and image are made from
+	TArray<FString> Parts;
+	Parts.Add(Node->GetClass()->GetPathName());
+	Parts.Add(Snapshot.NodeId);
+	Parts.Add(Snapshot.ClassId);
+	Parts.Add(Snapshot.ClassDisplayName);
+	Parts.Add(Snapshot.ShortTitle);
+	Parts.Add(Snapshot.FullTitle);
+	Parts.Add(Snapshot.Description);
+	Parts.Add(Snapshot.Category);
+
+	if (auto FuncNode = Cast<UK2Node_CallFunction>(Node))
+	{
+		if (UFunction* Func = FuncNode->GetTargetFunction())
+		{
+			Parts.Add(Func->GetPathName());
+			Parts.Add(FString::Printf(TEXT("%u"), (uint32) Func->FunctionFlags));
+			Parts.Add(Func->GetMetaData(TEXT("Comment")));
+			Parts.Add(Func->GetMetaData(TEXT("ToolTip")));
+			Parts.Add(Func->HasMetaData(TEXT("BlueprintAutocast")) ? TEXT("autocast") : TEXT(""));
+			for (TFieldIterator<FProperty> It(Func); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+			{
+				FString ExtendedType;
+				FString const Type = It->GetCPPType(&ExtendedType);
+				Parts.Add(FString::Printf(TEXT("%s %s%s %llu"), *It->GetAuthoredName(), *Type, *ExtendedType,
+										  (uint64) It->PropertyFlags));
+			}
+		}
+	}
+
+	for (UEdGraphPin* Pin : Node->Pins)
+	{
+		FEdGraphPinType const& Type = Pin->PinType;
+		Parts.Add(FString::Printf(TEXT("%d %d %s %s %s %s %d %d %d %s"), (int32) Pin->Direction,
+								  Pin->bHidden ? 1 : 0, *Pin->PinName.ToString(), *Type.PinCategory.ToString(),
+								  *Type.PinSubCategory.ToString(), *GetPathNameSafe(Type.PinSubCategoryObject.Get()),
+								  (int32) Type.ContainerType, Type.bIsReference ? 1 : 0, Type.bIsConst ? 1 : 0,
+								  *Pin->DefaultValue));
+	}
+	for (auto const& Pin : Snapshot.Pins)
+	{
+		Parts.Add(FString::Printf(TEXT("%d %s %s %s"), (int32) Pin.Direction, *Pin.Name, *Pin.Type,
+								  *Pin.Description));
+	}
+
+	FTCHARToUTF8 Utf8(*FString::Join(Parts, TEXT("\n")));
+	FMD5 Md5;
+	Md5.Update((const uint8*) Utf8.Get(), Utf8.Length());
+	return NodeDocsGenerator::FinishHash(Md5);
+}
+
+void FNodeDocsGenerator::GT_RecordNodeDependencies(UK2Node* Node, FNodeProcessingState const& State)
+{
+	if (Manifest == nullptr)
+	{
+		return;
+	}
+
+	TArray<FString> TypePaths;
+	auto AddType = [&TypePaths](UObject* Type) {
+		if (Type && (Type->IsA<UStruct>() || Type->IsA<UEnum>()))
+		{
+			TypePaths.AddUnique(Type->GetPathName());
+		}
+	};
+	for (UEdGraphPin* Pin : Node->Pins)
+	{
+		AddType(Pin->PinType.PinSubCategoryObject.Get());
+		AddType(Pin->PinType.PinValueType.TerminalSubCategoryObject.Get());
+	}
+	if (TypePaths.Num() == 0)
+	{
+		return;
+	}
+
+	for (auto const& TypePath : TypePaths)
+	{
+		if (!Manifest->HasType(TypePath))
+		{
+			Manifest->RecordType(TypePath, GT_HashType(TypePath));
+		}
+	}
+	Manifest->RecordDependencies(MakeNodeKey(State.Snapshot.ClassId, State.Snapshot.NodeId), TypePaths);
+}
+
+FString FNodeDocsGenerator::GT_HashNodeImage(UEdGraphNode* Node)
+{
+	// Everything the node widget is drawn from, and what it is drawn with
+	TArray<FString> Parts;
+	Parts.Add(FEngineVersion::Current().ToString());
+	Parts.Add(NodeDocsGenerator::ImageDrawSize.ToString());
+	Parts.Add(Node->GetClass()->GetPathName());
+	Parts.Add(Node->GetNodeTitle(ENodeTitleType::FullTitle).ToString());
+	Parts.Add(Node->GetNodeTitleColor().ToString());
+	Parts.Add(FString::Printf(TEXT("%d"), (int32) Node->AdvancedPinDisplay.GetValue()));
+	if (auto K2Node = Cast<UK2Node>(Node))
+	{
+		Parts.Add(K2Node->IsNodePure() ? TEXT("pure") : TEXT(""));
+	}
+
+	for (UEdGraphPin* Pin : Node->Pins)
+	{
+		FEdGraphPinType const& Type = Pin->PinType;
+		Parts.Add(FString::Printf(TEXT("%d %d %d %d %s %s %s %s %d %d %d %s %s %s"), (int32) Pin->Direction,
+								  Pin->bHidden ? 1 : 0, Pin->bAdvancedView ? 1 : 0, Pin->bDefaultValueIsIgnored ? 1 : 0,
+								  *Pin->GetDisplayName().ToString(), *Type.PinCategory.ToString(),
+								  *Type.PinSubCategory.ToString(), *GetPathNameSafe(Type.PinSubCategoryObject.Get()),
+								  (int32) Type.ContainerType, Type.bIsReference ? 1 : 0, Type.bIsConst ? 1 : 0,
+								  *Pin->DefaultValue, *GetPathNameSafe(Pin->DefaultObject),
+								  *Pin->DefaultTextValue.ToString()));
+	}
+
+	FTCHARToUTF8 Utf8(*FString::Join(Parts, TEXT("\n")));
+	FMD5 Md5;
+	Md5.Update((const uint8*) Utf8.Get(), Utf8.Length());
+	return NodeDocsGenerator::FinishHash(Md5);
+}
+
+bool FNodeDocsGenerator::Finalize(FString const& OutputPath)
+{
+	FScopeLock Lock(&DocTreeLock);
 	if (!SaveClassDocFile(OutputPath))
 	{
 		return false;
@@ -122,6 +486,7 @@ bool FNodeDocsGenerator::GT_Finalize(FString OutputPath)
 	{
 		return false;
 	}
+	RemoveStaleFiles(OutputPath);
 
 	return true;
 }
@@ -143,59 +508,221 @@ void FNodeDocsGenerator::CleanUp()
 		Graph->RemoveFromRoot();
 		Graph.Reset();
 	}
+	for (auto const& Entry : LiveNodesPerGraph)
+	{
+		if (Entry.Key.IsValid())
+		{
+			Entry.Key->RemoveFromRoot();
+		}
+	}
+	LiveNodesPerGraph.Empty();
 }
 
-bool FNodeDocsGenerator::GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingState& State)
+void FNodeDocsGenerator::GT_FindCachedNodeImages(TArrayView<FNodeImageJob> Jobs)
 {
-	SCOPE_SECONDS_COUNTER(GenerateNodeImageTime);
-
-	const FVector2D DrawSize(1024.0f, 1024.0f);
-
-	bool bSuccess = false;
+	if (ImageCache == nullptr && DerivedData == nullptr)
+	{
+		return;
+	}
 
-	AdjustNodeForSnapshot(Node);
+	// Rendered by an earlier run, so SaveNodeImage just copies it into place
+	TArray<FNodeImageJob*> Uncached;
+	for (FNodeImageJob& Job : Jobs)
+	{
+		if (!Job.bUseCaches)
+		{
+			continue;
+		}
+		Job.State->ImageCacheKey = GT_HashNodeImage(Job.Node);
+		if (ImageCache && ImageCache->Contains(Job.State->ImageCacheKey))
+		{
+			Job.State->ImageSource = FNodeProcessingState::EImageSource::ImageCache;
+			Job.bRendered = true;
+		}
+		else
+		{
+			Uncached.Add(&Job);
+		}
+	}
+	if (DerivedData == nullptr || Uncached.Num() == 0)
+	{
+		return;
+	}
 
-	FString NodeName = GetNodeDocId(Node);
+	TArray<FString> Hashes;
+	Hashes.Reserve(Uncached.Num());
+	for (FNodeImageJob const* Job : Uncached)
+	{
+		Hashes.Add(Job->State->ImageCacheKey);
+	}
+	TBitArray<> const Found = DerivedData->ProbablyHasBatch(NodeDocsGenerator::NodeImageKind, Hashes);
+	for (int32 Index = 0; Index < Uncached.Num() && Index < Found.Num(); ++Index)
+	{
+		if (Found[Index])
+		{
+			Uncached[Index]->State->ImageSource = FNodeProcessingState::EImageSource::DerivedData;
+			Uncached[Index]->bRendered = true;
+		}
+	}
+}
 
-	FIntRect Rect;
+bool FNodeDocsGenerator::GT_RenderNodeImage(UEdGraphNode* Node, FNodeProcessingState& State)
+{
+	FNodeImageJob Job;
+	Job.Node = Node;
+	Job.State = &State;
+	GT_RenderNodeImages(MakeArrayView(&Job, 1));
+	return Job.bRendered;
+}
 
-	TUniquePtr<TImagePixelData<FColor>> PixelData;
+void FNodeDocsGenerator::GT_RenderNodeImages(TArrayView<FNodeImageJob> Jobs)
+{
+	// A node widget and the part of the atlas it is drawn into
+	struct FPlacedWidget
+	{
+		FNodeImageJob* Job;
+		TSharedPtr<SGraphNode> Widget;
+		FIntPoint Position;
+		FIntPoint Size;
+	};
 
-	auto RenderNodeResult = Async(EAsyncExecution::TaskGraphMainThread, [this, Node, DrawSize, &Rect, &PixelData] {
-		auto NodeWidget = FNodeFactory::CreateNodeWidget(Node);
-		NodeWidget->SetOwner(GraphPanel.ToSharedRef());
+	auto DrawAtlas = [](TArray<FPlacedWidget> const& Placed) -> bool {
+		TSharedRef<SCanvas> Canvas = SNew(SCanvas);
+		int32 Height = 0;
+		for (auto const& Entry : Placed)
+		{
+			Canvas->AddSlot().Position(FVector2D(Entry.Position)).Size(FVector2D(Entry.Size))
+				[
+					Entry.Widget.ToSharedRef()
+				];
+			Height = FMath::Max(Height, Entry.Position.Y + Entry.Size.Y);
+		}
+		FIntPoint const AtlasSize(NodeDocsGenerator::AtlasWidth, Height);
 
-		const bool bUseGammaCorrection = false;
 		FWidgetRenderer Renderer(false);
 		Renderer.SetIsPrepassNeeded(true);
-		auto RenderTarget = Renderer.DrawWidget(NodeWidget.ToSharedRef(), DrawSize);
-		auto Desired = NodeWidget->GetDesiredSize();
+		auto RenderTarget = Renderer.DrawWidget(Canvas, FVector2D(AtlasSize));
 #if UE_VERSION_NEWER_THAN(5, 0, 0)
 		FlushRenderingCommands();
-#else 
+#else
 		FlushRenderingCommands(true);
 #endif
 		FTextureRenderTargetResource* RTResource = RenderTarget->GameThread_GetRenderTargetResource();
-		Rect = FIntRect(0, 0, (int32) Desired.X, (int32) Desired.Y);
 		FReadSurfaceDataFlags ReadPixelFlags(RCM_UNorm);
 		ReadPixelFlags.SetLinearToGamma(true); // @TODO: is this gamma correction, or something else?
 
-		PixelData = MakeUnique<TImagePixelData<FColor>>(FIntPoint((int32) Desired.X, (int32) Desired.Y));
-		PixelData->Pixels.SetNumUninitialized(Desired.X * Desired.Y);
-
-		if (RTResource->ReadPixelsPtr(PixelData->Pixels.GetData(), ReadPixelFlags, Rect) == false)
+		// One readback for the whole atlas, sliced up into the node images
+		TArray<FColor> AtlasPixels;
+		bool const bRead = RTResource->ReadPixels(AtlasPixels, ReadPixelFlags, FIntRect(FIntPoint(0, 0), AtlasSize));
+		BeginReleaseResource(RTResource);
+		if (!bRead)
 		{
-			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to read pixels for node image."));
 			return false;
 		}
-		BeginReleaseResource(RTResource);
+
+		for (auto const& Entry : Placed)
+		{
+			auto PixelData = MakeUnique<TImagePixelData<FColor>>(Entry.Size);
+			PixelData->Pixels.SetNumUninitialized(Entry.Size.X * Entry.Size.Y);
+			for (int32 Row = 0; Row < Entry.Size.Y; ++Row)
+			{
+				FColor const* Source = &AtlasPixels[(Entry.Position.Y + Row) * AtlasSize.X + Entry.Position.X];
+				FMemory::Memcpy(&PixelData->Pixels[Row * Entry.Size.X], Source, Entry.Size.X * sizeof(FColor));
+			}
+			Entry.Job->State->PixelData = MoveTemp(PixelData);
+			Entry.Job->bRendered = true;
+		}
 		return true;
-	});
+	};
 
-	if (!RenderNodeResult.Get())
+	// A failed readback would otherwise lose every image in the atlas, so its nodes are then drawn one at a time
+	auto DrawPlaced = [&DrawAtlas](TArray<FPlacedWidget> const& Placed) {
+		if (DrawAtlas(Placed))
+		{
+			return;
+		}
+		if (Placed.Num() > 1)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to read pixels for an atlas of %d node images, drawing "
+												  "them one at a time."), Placed.Num());
+		}
+		for (FPlacedWidget Entry : Placed)
+		{
+			Entry.Position = FIntPoint(0, 0);
+			if (Placed.Num() == 1 || !DrawAtlas({Entry}))
+			{
+				UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to read pixels for node image %s."),
+					   *GetNodeDocId(Entry.Job->Node));
+			}
+		}
+	};
+
+	// Shelf packing: nodes go left to right along a row as tall as the tallest of them, then on to the next row
+	TArray<FPlacedWidget> Placed;
+	FIntPoint Cursor(0, 0);
+	int32 ShelfHeight = 0;
+	for (FNodeImageJob& Job : Jobs)
 	{
-		return false;
+		Job.bRendered = false;
+		AdjustNodeForSnapshot(Job.Node);
 	}
+	GT_FindCachedNodeImages(Jobs);
+
+	for (FNodeImageJob& Job : Jobs)
+	{
+		if (Job.bRendered)
+		{
+			continue;
+		}
+
+		auto NodeWidget = FNodeFactory::CreateNodeWidget(Job.Node);
+		NodeWidget->SetOwner(GraphPanel.ToSharedRef());
+		NodeWidget->SlatePrepass(1.0f);
+		FVector2D const Desired = NodeWidget->GetDesiredSize();
+		// No larger than the target each node used to be drawn into on its own
+		FIntPoint const Size((int32) FMath::Min(Desired.X, NodeDocsGenerator::ImageDrawSize.X),
+							 (int32) FMath::Min(Desired.Y, NodeDocsGenerator::ImageDrawSize.Y));
+		if (Size.X <= 0 || Size.Y <= 0)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Node %s has nothing to draw."), *GetNodeDocId(Job.Node));
+			continue;
+		}
+
+		if (Cursor.X + Size.X > NodeDocsGenerator::AtlasWidth)
+		{
+			Cursor = FIntPoint(0, Cursor.Y + ShelfHeight + NodeDocsGenerator::AtlasPadding);
+			ShelfHeight = 0;
+		}
+		if (Cursor.Y + Size.Y > NodeDocsGenerator::AtlasMaxHeight)
+		{
+			DrawPlaced(Placed);
+			Placed.Reset();
+			Cursor = FIntPoint(0, 0);
+			ShelfHeight = 0;
+		}
+
+		Placed.Add({&Job, NodeWidget, Cursor, Size});
+		Cursor.X += Size.X + NodeDocsGenerator::AtlasPadding;
+		ShelfHeight = FMath::Max(ShelfHeight, Size.Y);
+	}
+
+	if (Placed.Num() > 0)
+	{
+		DrawPlaced(Placed);
+	}
+}
+
+FNodeDocsGenerator::ESaveImageResult FNodeDocsGenerator::SaveNodeImage(FNodeProcessingState& State)
+{
+	bool const bRendered = State.ImageSource == FNodeProcessingState::EImageSource::Render;
+	if (bRendered && !State.PixelData.IsValid())
+	{
+		return ESaveImageResult::Failed;
+	}
+
+	ESaveImageResult Result = ESaveImageResult::Failed;
+
+	FString const& NodeName = State.Snapshot.NodeId;
 
 	State.RelImageBasePath = TEXT("../img");
 	FString ImageBasePath = State.ClassDocsPath / TEXT("img"); // State.RelImageBasePath;
@@ -206,8 +733,42 @@ bool FNodeDocsGenerator::GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingSt
 	FString ImgFilename = FString::Printf(TEXT("nd_img_%s.png"), *NodeName);
 	FString ScreenshotSaveName = ImageBasePath / ImgFilename;
 
+	if (State.ImageSource == FNodeProcessingState::EImageSource::ImageCache)
+	{
+		if (!ImageCache->Retrieve(State.ImageCacheKey, ScreenshotSaveName))
+		{
+			// Evicted or removed since it was looked up
+			State.ImageSource = FNodeProcessingState::EImageSource::Render;
+			return ESaveImageResult::NeedsRender;
+		}
+		State.ImageFilename = ImgFilename;
+		return ESaveImageResult::Saved;
+	}
+	if (State.ImageSource == FNodeProcessingState::EImageSource::DerivedData)
+	{
+		TArray<uint8> PngData;
+		if (!DerivedData->Get(NodeDocsGenerator::NodeImageKind, State.ImageCacheKey, PngData))
+		{
+			// ProbablyHas can be wrong, and a shared cache can lose entries
+			State.ImageSource = FNodeProcessingState::EImageSource::Render;
+			return ESaveImageResult::NeedsRender;
+		}
+		if (!FFileHelper::SaveArrayToFile(PngData, *ScreenshotSaveName))
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to write node image from the derived data cache: %s"),
+				   *NodeName);
+			return ESaveImageResult::Failed;
+		}
+		State.ImageFilename = ImgFilename;
+		if (ImageCache)
+		{
+			ImageCache->Store(State.ImageCacheKey, ScreenshotSaveName);
+		}
+		return ESaveImageResult::Saved;
+	}
+
 	TUniquePtr<FImageWriteTask> ImageTask = MakeUnique<FImageWriteTask>();
-	ImageTask->PixelData = MoveTemp(PixelData);
+	ImageTask->PixelData = MoveTemp(State.PixelData);
 	ImageTask->Filename = ScreenshotSaveName;
 	ImageTask->Format = EImageFormat::PNG;
 	ImageTask->CompressionQuality = (int32) EImageCompressionQuality::Default;
@@ -228,20 +789,30 @@ bool FNodeDocsGenerator::GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingSt
 	if (ImageTask->RunTask())
 	{
 		// Success!
-		bSuccess = true;
+		Result = ESaveImageResult::Saved;
 		State.ImageFilename = ImgFilename;
+		if (ImageCache && !State.ImageCacheKey.IsEmpty())
+		{
+			ImageCache->Store(State.ImageCacheKey, ScreenshotSaveName);
+		}
+		TArray<uint8> PngData;
+		if (DerivedData && !State.ImageCacheKey.IsEmpty() && FFileHelper::LoadFileToArray(PngData, *ScreenshotSaveName))
+		{
+			DerivedData->Put(NodeDocsGenerator::NodeImageKind, State.ImageCacheKey, PngData);
+		}
 	}
 	else
 	{
 		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save screenshot image for node: %s"), *NodeName);
 	}
 
-	return bSuccess;
+	return Result;
 }
 
-// For K2 pins only!
-bool ExtractPinInformation(UEdGraphPin* Pin, FString& OutName, FString& OutType, FString& OutDescription)
+// For K2 pins only! The type is left to the caller, which has it memoized.
+bool ExtractPinInformation(UEdGraphPin* Pin, FString& OutName, FString& OutDescription)
 {
+	FString TypeLine;
 	FString Tooltip;
 	Pin->GetOwningNode()->GetPinHoverText(*Pin, Tooltip);
 
@@ -255,7 +826,7 @@ bool ExtractPinInformation(UEdGraphPin* Pin, FString& OutName, FString& OutType,
 		// Parse name line
 		FParse::Line(&TooltipPtr, OutName);
 		// Parse type line
-		FParse::Line(&TooltipPtr, OutType);
+		FParse::Line(&TooltipPtr, TypeLine);
 
 		// Currently there is an empty line here, but FParse::Line seems to gobble up empty lines as part of the
 		// previous call. Anyway, attempting here to deal with this generically in case that weird behaviour changes.
@@ -270,6 +841,7 @@ bool ExtractPinInformation(UEdGraphPin* Pin, FString& OutName, FString& OutType,
 	}
 
 	// @NOTE: Currently overwriting the name and type as suspect this is more robust to future engine changes.
+	// The type is overwritten by the caller.
 
 	OutName = Pin->GetDisplayName().ToString();
 	if (OutName.IsEmpty() && Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec)
@@ -277,11 +849,37 @@ bool ExtractPinInformation(UEdGraphPin* Pin, FString& OutName, FString& OutType,
 		OutName = Pin->Direction == EEdGraphPinDirection::EGPD_Input ? TEXT("In") : TEXT("Out");
 	}
 
-	OutType = UEdGraphSchema_K2::TypeToText(Pin->PinType).ToString();
-
 	return true;
 }
 
+TSharedRef<Detail::FDoxygenTags const, ESPMode::ThreadSafe> FNodeDocsGenerator::GetDoxygenTags(
+	TWeakObjectPtr<UObject> Owner, FString const& Comment)
+{
+	if (!Owner.IsExplicitlyNull())
+	{
+		FScopeLock Lock(&DoxygenTagsCacheLock);
+		if (auto Cached = DoxygenTagsCache.Find(Owner))
+		{
+			return *Cached;
+		}
+	}
+
+	// Parsed outside the lock. Should two threads race on the same owner, the first one in wins.
+	auto Tags = MakeShared<Detail::FDoxygenTags, ESPMode::ThreadSafe>();
+	Detail::ParseDoxygenTags(Comment, *Tags);
+	if (Owner.IsExplicitlyNull())
+	{
+		return Tags;
+	}
+
+	FScopeLock Lock(&DoxygenTagsCacheLock);
+	if (auto Cached = DoxygenTagsCache.Find(Owner))
+	{
+		return *Cached;
+	}
+	return DoxygenTagsCache.Add(Owner, Tags);
+}
+
 TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitIndexDocTree(FString const& IndexTitle)
 {
 	TSharedPtr<DocTreeNode> IndexDocTree = MakeShared<DocTreeNode>();
@@ -292,415 +890,627 @@ TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitIndexDocTree(FString const& Inde
 	return IndexDocTree;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitClassDocTree(UClass* Class)
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitClassDocTree(FString const& ClassId, FString const& ClassDisplayName)
 {
 	TSharedPtr<DocTreeNode> ClassDoc = MakeShared<DocTreeNode>();
 	ClassDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
-	ClassDoc->AppendChildWithValueEscaped(TEXT("id"), GetClassDocId(Class));
-	ClassDoc->AppendChildWithValueEscaped(TEXT("display_name"),
-										  FBlueprintEditorUtils::GetFriendlyClassDisplayName(Class).ToString());
+	ClassDoc->AppendChildWithValueEscaped(TEXT("id"), ClassId);
+	ClassDoc->AppendChildWithValueEscaped(TEXT("display_name"), ClassDisplayName);
 	ClassDoc->AppendChild(TEXT("nodes"));
 	ClassDoc->AppendChild(TEXT("fields"));
 	return ClassDoc;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitStructDocTree(UScriptStruct* Struct)
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitStructDocTree(FString const& StructId, FString const& DisplayName)
+{
+	TSharedPtr<DocTreeNode> StructDoc = MakeShared<DocTreeNode>();
+	StructDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
+	StructDoc->AppendChildWithValueEscaped(TEXT("id"), StructId);
+	StructDoc->AppendChildWithValueEscaped(TEXT("display_name"), DisplayName);
+	StructDoc->AppendChild(TEXT("fields"));
+	return StructDoc;
+}
+
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitEnumDocTree(FString const& EnumId, FString const& DisplayName)
+{
+	TSharedPtr<DocTreeNode> EnumDoc = MakeShared<DocTreeNode>();
+	EnumDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
+	EnumDoc->AppendChildWithValueEscaped(TEXT("id"), EnumId);
+	EnumDoc->AppendChildWithValueEscaped(TEXT("display_name"), DisplayName);
+	EnumDoc->AppendChild(TEXT("values"));
+	return EnumDoc;
+}
+
+bool FNodeDocsGenerator::UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree, FString const& ClassId,
+												  FString const& ClassDisplayName)
+{
+	auto DocTreeClassesElement = DocTree->FindChildByName("classes");
+	auto DocTreeClass = DocTreeClassesElement->AppendChild("class");
+	DocTreeClass->AppendChildWithValueEscaped(TEXT("id"), ClassId);
+	DocTreeClass->AppendChildWithValueEscaped(TEXT("display_name"), ClassDisplayName);
+	return true;
+}
+
+bool FNodeDocsGenerator::UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTree, FString const& StructId,
+												   FString const& DisplayName)
+{
+	auto DocTreeStructsElement = DocTree->FindChildByName("structs");
+	auto DocTreeStruct = DocTreeStructsElement->AppendChild("struct");
+	DocTreeStruct->AppendChildWithValueEscaped(TEXT("id"), StructId);
+	DocTreeStruct->AppendChildWithValueEscaped(TEXT("display_name"), DisplayName);
+	return true;
+}
+
+bool FNodeDocsGenerator::UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree, FString const& EnumId,
+												 FString const& DisplayName)
+{
+	auto DocTreeEnumsElement = DocTree->FindChildByName("enums");
+	auto DocTreeEnum = DocTreeEnumsElement->AppendChild("enum");
+	DocTreeEnum->AppendChildWithValueEscaped(TEXT("id"), EnumId);
+	DocTreeEnum->AppendChildWithValueEscaped(TEXT("display_name"), DisplayName);
+	return true;
+}
+
+bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, FString const& NodeId,
+												 FString const& ShortTitle)
+{
+	auto DocTreeNodesElement = DocTree->FindChildByName("nodes");
+	auto DocTreeNode = DocTreeNodesElement->AppendChild("node");
+	DocTreeNode->AppendChildWithValueEscaped(TEXT("id"), NodeId);
+	DocTreeNode->AppendChildWithValueEscaped(TEXT("shorttitle"), ShortTitle);
+	return true;
+}
+
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::FindOrAddClassDocTree(FString const& ClassId,
+																  FString const& ClassDisplayName)
+{
+	if (TSharedPtr<DocTreeNode>* Found = ClassDocTreeMap.Find(ClassId))
+	{
+		return *Found;
+	}
+
+	TSharedPtr<DocTreeNode> ClassDocTree = InitClassDocTree(ClassId, ClassDisplayName);
+	ClassDocTreeMap.Add(ClassId, ClassDocTree);
+	UpdateIndexDocWithClass(IndexTree, ClassId, ClassDisplayName);
+	return ClassDocTree;
+}
+
+bool FNodeDocsGenerator::SaveNodeDocFile(FString const& ClassDocsPath, FString const& NodeId,
+										 TSharedPtr<DocTreeNode> NodeDocBody)
+{
+	TSharedPtr<DocTreeNode> NodeDocFile = MakeShared<DocTreeNode>();
+	NodeDocFile->AppendChildWithValueEscaped("docs_name", DocsTitle);
+	NodeDocFile->AppendChildrenOf(*NodeDocBody);
+
+	auto NodeDocsPath = ClassDocsPath / TEXT("nodes");
+	bool bSuccess = true;
+	for (const auto& FactoryObject : OutputFormats)
+	{
+		auto Serializer = FactoryObject->CreateSerializer();
+		NodeDocFile->SerializeWith(Serializer);
+		bSuccess &= Serializer->SaveToFile(NodeDocsPath, NodeId);
+	}
+	return bSuccess;
+}
+
+bool FNodeDocsGenerator::RegisterDocumentedNode(FDocumentedNode const& Node)
+{
+	{
+		FScopeLock Lock(&DocTreeLock);
+		bool bAlreadyDocumented = false;
+		DocumentedNodeKeys.Add(MakeNodeKey(Node.ClassId, Node.NodeId), &bAlreadyDocumented);
+		if (bAlreadyDocumented)
+		{
+			return true;
+		}
+	}
+
+	FString const ClassDocsPath = OutputDir / Node.ClassId;
+
+	if (Node.NodeDocBody.IsValid())
+	{
+		if (!Node.ImageFile.IsEmpty())
+		{
+			FString const ImageFile = ClassDocsPath / TEXT("img") / FPaths::GetCleanFilename(Node.ImageFile);
+			if (ImageFile != Node.ImageFile &&
+				IFileManager::Get().Copy(*ImageFile, *Node.ImageFile, true) != COPY_OK)
+			{
+				UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to copy node image %s"), *Node.ImageFile);
+				return false;
+			}
+		}
+
+		// The body may be shared with other threads, so serialize from a private copy
+		if (!SaveNodeDocFile(ClassDocsPath, Node.NodeId, Node.NodeDocBody->Clone()))
+		{
+			return false;
+		}
+	}
+
+	FScopeLock Lock(&DocTreeLock);
+	auto ClassDocTree = FindOrAddClassDocTree(Node.ClassId, Node.ClassDisplayName);
+	return UpdateClassDocWithNode(ClassDocTree, Node.NodeId, Node.ShortTitle);
+}
+
+inline bool ShouldDocumentPin(UEdGraphPin* Pin)
+{
+	return !Pin->bHidden;
+}
+
+inline FString TrimTargetSuffix(FString const& Text)
+{
+	auto TargetIdx = Text.Find(TEXT("Target is "), ESearchCase::CaseSensitive);
+	return TargetIdx != INDEX_NONE ? Text.Left(TargetIdx).TrimEnd() : Text;
+}
+
+FEdGraphPinType const& FNodeDocsGenerator::FPinTypeKeyFuncs::GetSetKey(TPair<FEdGraphPinType, FString> const& Element)
+{
+	return Element.Key;
+}
+
+bool FNodeDocsGenerator::FPinTypeKeyFuncs::Matches(FEdGraphPinType const& A, FEdGraphPinType const& B)
+{
+	return A == B;
+}
+
+uint32 FNodeDocsGenerator::FPinTypeKeyFuncs::GetKeyHash(FEdGraphPinType const& Key)
+{
+	// Only what tells common types apart, Matches compares the rest
+	uint32 Hash = HashCombine(GetTypeHash(Key.PinCategory), GetTypeHash(Key.PinSubCategory));
+	Hash = HashCombine(Hash, GetTypeHash(Key.PinSubCategoryObject));
+	Hash = HashCombine(Hash, GetTypeHash(Key.PinValueType.TerminalCategory));
+	Hash = HashCombine(Hash, GetTypeHash(Key.PinValueType.TerminalSubCategoryObject));
+	uint32 const Flags = ((uint32) Key.ContainerType << 2) | (Key.bIsReference ? 2u : 0u) | (Key.bIsConst ? 1u : 0u);
+	return HashCombine(Hash, Flags);
+}
+
+FString const& FNodeDocsGenerator::GT_GetPinTypeText(FEdGraphPinType const& PinType)
+{
+	if (FString const* TypeText = PinTypeTextCache.Find(PinType))
+	{
+		return *TypeText;
+	}
+	return PinTypeTextCache.Add(PinType, UEdGraphSchema_K2::TypeToText(PinType).ToString());
+}
+
+void FNodeDocsGenerator::GT_SnapshotNode(UK2Node* Node, FNodeSnapshot& OutSnapshot)
 {
-	TSharedPtr<DocTreeNode> StructDoc = MakeShared<DocTreeNode>();
-	StructDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
-	StructDoc->AppendChildWithValueEscaped(TEXT("id"), Struct->GetName());
-	if (Struct->HasMetaData(TEXT("DisplayName")))
+	OutSnapshot.ShortTitle = Node->GetNodeTitle(ENodeTitleType::ListView).ToString();
+	OutSnapshot.FullTitle = TrimTargetSuffix(Node->GetNodeTitle(ENodeTitleType::FullTitle).ToString());
+	OutSnapshot.Description = TrimTargetSuffix(Node->GetTooltipText().ToString());
+	OutSnapshot.Category = Node->GetMenuCategory().ToString();
+
+	OutSnapshot.Pins.Reset();
+	for (auto Pin : Node->Pins)
 	{
-		StructDoc->AppendChildWithValueEscaped(TEXT("display_name"), Struct->GetMetaData(TEXT("DisplayName")));
+		if (ShouldDocumentPin(Pin))
+		{
+			FNodeSnapshot::FPin& PinText = OutSnapshot.Pins.AddDefaulted_GetRef();
+			PinText.Direction = Pin->Direction;
+			ExtractPinInformation(Pin, PinText.Name, PinText.Description);
+			PinText.Type = GT_GetPinTypeText(Pin->PinType);
+		}
 	}
-	else
+
+	OutSnapshot.Function.Reset();
+	auto FuncNode = Cast<UK2Node_CallFunction>(Node);
+	OutSnapshot.bIsFunctionCall = FuncNode != nullptr;
+	UFunction* Func = FuncNode ? FuncNode->GetTargetFunction() : nullptr;
+	if (Func == nullptr)
 	{
-		StructDoc->AppendChildWithValueEscaped(TEXT("display_name"),
-											   FName::NameToDisplayString(Struct->GetName(), false));
+		return;
 	}
-	StructDoc->AppendChild(TEXT("fields"));
-	return StructDoc;
-}
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitEnumDocTree(UEnum* Enum)
-{
-	TSharedPtr<DocTreeNode> EnumDoc = MakeShared<DocTreeNode>();
-	EnumDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
-	EnumDoc->AppendChildWithValueEscaped(TEXT("id"), Enum->GetName());
-	if (Enum->HasMetaData(TEXT("DisplayName")))
+	FNodeSnapshot::FFunction& Function = OutSnapshot.Function.Emplace();
+	Function.Name = Func->GetAuthoredName();
+	Function.Comment = Func->GetMetaData(TEXT("Comment"));
+	Function.bStatic = Func->HasAnyFunctionFlags(FUNC_Static);
+	Function.bAutocast = Func->HasMetaData(TEXT("BlueprintAutocast"));
+	Function.DoxygenTags = GetDoxygenTags(Func, Function.Comment);
+
+	TArray<FStringFormatArg> Args;
+	if (FProperty* RetProp = Func->GetReturnProperty())
 	{
-		EnumDoc->AppendChildWithValueEscaped(TEXT("display_name"), Enum->GetMetaData(TEXT("DisplayName")));
+		FString ExtendedParameters;
+		FString RetValType = RetProp->GetCPPType(&ExtendedParameters);
+		Args.Add({RetValType + ExtendedParameters});
 	}
 	else
 	{
-		EnumDoc->AppendChildWithValueEscaped(TEXT("display_name"), Enum->GetName());
+		Args.Add({"void"});
 	}
-	EnumDoc->AppendChild(TEXT("values"));
-	return EnumDoc;
-}
+	Args.Add({Function.Name});
+	FString FuncParams;
+	for (TFieldIterator<FProperty> PropertyIterator(Func);
+		 PropertyIterator && (PropertyIterator->PropertyFlags & CPF_Parm | CPF_Parm); ++PropertyIterator)
+	{
+		FProperty* FuncParameter = *PropertyIterator;
 
-bool FNodeDocsGenerator::UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree, UClass* Class)
-{
-	auto DocTreeClassesElement = DocTree->FindChildByName("classes");
-	auto DocTreeClass = DocTreeClassesElement->AppendChild("class");
-	DocTreeClass->AppendChildWithValueEscaped(TEXT("id"), GetClassDocId(Class));
-	DocTreeClass->AppendChildWithValueEscaped(TEXT("display_name"),
-											  FBlueprintEditorUtils::GetFriendlyClassDisplayName(Class).ToString());
-	return true;
+		// Skip the return type as we handled it earlier
+		if (FuncParameter->HasAllPropertyFlags(CPF_ReturnParm))
+		{
+			continue;
+		}
+
+		FString ExtendedParameters;
+		FString ParamType = FuncParameter->GetCPPType(&ExtendedParameters);
+
+		FString ParamString = ParamType + ExtendedParameters + " " + FuncParameter->GetAuthoredName();
+		if (FuncParams.Len() != 0)
+		{
+			FuncParams.Append(", ");
+		}
+		FuncParams.Append(ParamString);
+	}
+	Args.Add({FuncParams});
+	Args.Add({Func->HasAnyFunctionFlags(FUNC_Const) ? " const" : ""});
+	Function.Signature = FString::Format(TEXT("{0} {1}({2}){3}"), Args);
 }
 
-bool FNodeDocsGenerator::UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTree, UStruct* Struct)
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::BuildNodeDocBody(FNodeProcessingState const& State)
 {
-	auto DocTreeStructsElement = DocTree->FindChildByName("structs");
-	auto DocTreeStruct = DocTreeStructsElement->AppendChild("struct");
-	DocTreeStruct->AppendChildWithValueEscaped(TEXT("id"), Struct->GetName());
-	if (Struct->HasMetaData(TEXT("DisplayName")))
+	FNodeSnapshot const& Snapshot = State.Snapshot;
+	TSharedPtr<DocTreeNode> NodeDocFile = MakeShared<DocTreeNode>();
+	NodeDocFile->AppendChildWithValueEscaped("class_id", Snapshot.ClassId);
+	NodeDocFile->AppendChildWithValueEscaped("class_name", Snapshot.ClassDisplayName);
+	NodeDocFile->AppendChildWithValueEscaped("shorttitle", Snapshot.ShortTitle.TrimEnd());
+
+	FString const& NodeFullTitle = Snapshot.FullTitle;
+	NodeDocFile->AppendChildWithValueEscaped("fulltitle", NodeFullTitle);
+	NodeDocFile->AppendChildWithValueEscaped("description", Snapshot.Description);
+
+	NodeDocFile->AppendChildWithValueEscaped("imgpath", State.RelImageBasePath / State.ImageFilename);
+	NodeDocFile->AppendChildWithValueEscaped("category", Snapshot.Category);
+
+	if (Snapshot.bIsFunctionCall)
 	{
-		DocTreeStruct->AppendChildWithValueEscaped(TEXT("display_name"), Struct->GetMetaData(TEXT("DisplayName")));
+		if (Snapshot.Function.IsSet())
+		{
+			FNodeSnapshot::FFunction const& Function = Snapshot.Function.GetValue();
+			NodeDocFile->AppendChildWithValueEscaped("funcname", Function.Name);
+			NodeDocFile->AppendChildWithValueEscaped("rawcomment", Function.Comment);
+			NodeDocFile->AppendChildWithValue("static", Function.bStatic ? "true" : "false");
+			NodeDocFile->AppendChildWithValue("autocast", Function.bAutocast ? "true" : "false");
+			NodeDocFile->AppendChildWithValueEscaped("rawsignature", Function.Signature);
+
+			if (Function.DoxygenTags.IsValid())
+			{
+				NodeDocsGenerator::AppendDoxygenTags(NodeDocFile, *Function.DoxygenTags);
+			}
+		}
+		else
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("[KantanDocGen] Failed to get target function for node %s "),
+				   *NodeFullTitle);
+		}
 	}
 	else
 	{
-		DocTreeStruct->AppendChildWithValueEscaped(TEXT("display_name"),
-												   FName::NameToDisplayString(Struct->GetName(), false));
+		UE_LOG(LogKantanDocGen, Warning, TEXT("[KantanDocGen] Cannot get type for node %s "),
+			   *NodeFullTitle);
 	}
-	return true;
-}
+	auto InputNode = NodeDocFile->AppendChild("inputs");
 
-bool FNodeDocsGenerator::UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree, UEnum* Enum)
-{
-	auto DocTreeEnumsElement = DocTree->FindChildByName("enums");
-	auto DocTreeEnum = DocTreeEnumsElement->AppendChild("enum");
-	DocTreeEnum->AppendChildWithValueEscaped(TEXT("id"), Enum->GetName());
-	if (Enum->HasMetaData(TEXT("DisplayName")))
+	for (auto const& Pin : Snapshot.Pins)
 	{
-		DocTreeEnum->AppendChildWithValueEscaped(TEXT("display_name"), Enum->GetMetaData(TEXT("DisplayName")));
+		if (Pin.Direction == EEdGraphPinDirection::EGPD_Input)
+		{
+			auto Input = InputNode->AppendChild(TEXT("param"));
+			Input->AppendChildWithValueEscaped(TEXT("name"), Pin.Name);
+			Input->AppendChildWithValueEscaped(TEXT("type"), Pin.Type);
+			Input->AppendChildWithValueEscaped(TEXT("description"), Pin.Description);
+		}
 	}
-	else
+
+	auto OutputNode = NodeDocFile->AppendChild(TEXT("outputs"));
+	for (auto const& Pin : Snapshot.Pins)
 	{
-		DocTreeEnum->AppendChildWithValueEscaped(TEXT("display_name"), Enum->GetName());
-		// FName::NameToDisplayString(Enum->GetName(), false));
+		if (Pin.Direction == EEdGraphPinDirection::EGPD_Output)
+		{
+			auto Output = OutputNode->AppendChild(TEXT("param"));
+			Output->AppendChildWithValueEscaped(TEXT("name"), Pin.Name);
+			Output->AppendChildWithValueEscaped(TEXT("type"), Pin.Type);
+			Output->AppendChildWithValueEscaped(TEXT("description"), Pin.Description);
+		}
 	}
-	return true;
-}
 
-bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, UEdGraphNode* Node)
-{
-	auto DocTreeNodesElement = DocTree->FindChildByName("nodes");
-	auto DocTreeNode = DocTreeNodesElement->AppendChild("node");
-	DocTreeNode->AppendChildWithValueEscaped(TEXT("id"), GetNodeDocId(Node));
-	DocTreeNode->AppendChildWithValueEscaped(TEXT("shorttitle"),
-											 Node->GetNodeTitle(ENodeTitleType::ListView).ToString());
-	return true;
+	return NodeDocFile;
 }
 
-inline bool ShouldDocumentPin(UEdGraphPin* Pin)
+bool FNodeDocsGenerator::GenerateNodeDocTree(FNodeProcessingState& State)
 {
-	return !Pin->bHidden;
-}
+	// May be running on several worker threads at once, so accumulate locally and add to the total under the lock
+	double const StartTime = FPlatformTime::Seconds();
 
-bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState& State)
-{
-	if (auto EventNode = Cast<UK2Node_Event>(Node)) {
-		return true; //Skip events
+	// Everything except 'docs_name', so that the body can be shared with other documentation sets.
+	// A node with the same content hash documented anywhere before has the same body.
+	TSharedPtr<DocTreeNode> NodeDocFile;
+	if (DerivedData && !State.NodeHash.IsEmpty())
+	{
+		NodeDocFile = DerivedData->GetDocTree(NodeDocsGenerator::NodeDocKind, State.NodeHash);
+	}
+	if (!NodeDocFile.IsValid())
+	{
+		NodeDocFile = BuildNodeDocBody(State);
+		if (DerivedData && !State.NodeHash.IsEmpty())
+		{
+			DerivedData->PutDocTree(NodeDocsGenerator::NodeDocKind, State.NodeHash, NodeDocFile);
+		}
 	}
-	SCOPE_SECONDS_COUNTER(GenerateNodeDocsTime);
-
-	auto NodeDocsPath = State.ClassDocsPath / TEXT("nodes");
 
-	TSharedPtr<DocTreeNode> NodeDocFile = MakeShared<DocTreeNode>();
-	NodeDocFile->AppendChildWithValueEscaped("docs_name", DocsTitle);
-	NodeDocFile->AppendChildWithValueEscaped("class_id", State.ClassDocTree->FindChildByName("id")->GetValue());
-	NodeDocFile->AppendChildWithValueEscaped("class_name",
-											 State.ClassDocTree->FindChildByName("display_name")->GetValue());
-	NodeDocFile->AppendChildWithValueEscaped("shorttitle",
-											 Node->GetNodeTitle(ENodeTitleType::ListView).ToString().TrimEnd());
+	FDocumentedNode& Documented = State.Documented;
+	Documented.ClassId = State.Snapshot.ClassId;
+	Documented.ClassDisplayName = State.Snapshot.ClassDisplayName;
+	Documented.NodeId = State.Snapshot.NodeId;
+	Documented.ShortTitle = State.Snapshot.ShortTitle;
+	Documented.ImageFile = State.ClassDocsPath / TEXT("img") / State.ImageFilename;
+	Documented.NodeDocBody = NodeDocFile;
 
-	FString NodeFullTitle = Node->GetNodeTitle(ENodeTitleType::FullTitle).ToString();
-	auto TargetIdx = NodeFullTitle.Find(TEXT("Target is "), ESearchCase::CaseSensitive);
-	if (TargetIdx != INDEX_NONE)
+	if (SaveNodeDocFile(State.ClassDocsPath, Documented.NodeId, NodeDocFile) && Manifest && !State.NodeHash.IsEmpty())
 	{
-		NodeFullTitle = NodeFullTitle.Left(TargetIdx).TrimEnd();
+		Manifest->RecordNode(MakeNodeKey(Documented.ClassId, Documented.NodeId), State.NodeHash);
 	}
-	NodeDocFile->AppendChildWithValueEscaped("fulltitle", NodeFullTitle);
 
-	FString NodeDesc = Node->GetTooltipText().ToString();
-	TargetIdx = NodeDesc.Find(TEXT("Target is "), ESearchCase::CaseSensitive);
-	if (TargetIdx != INDEX_NONE)
+	FScopeLock Lock(&DocTreeLock);
+	GenerateNodeDocsTime += FPlatformTime::Seconds() - StartTime;
+	if (!UpdateClassDocWithNode(State.ClassDocTree, Documented.NodeId, Documented.ShortTitle))
 	{
-		NodeDesc = NodeDesc.Left(TargetIdx).TrimEnd();
+		return false;
 	}
-	NodeDocFile->AppendChildWithValueEscaped("description", NodeDesc);
 
-	NodeDocFile->AppendChildWithValueEscaped("imgpath", State.RelImageBasePath / State.ImageFilename);
-	NodeDocFile->AppendChildWithValueEscaped("category", Node->GetMenuCategory().ToString());
+	return true;
+}
 
-	if (auto FuncNode = Cast<UK2Node_CallFunction>(Node))
+namespace NodeDocsGenerator
+{
+	static void SnapshotFields(UStruct* Struct, TArray<FNodeDocsGenerator::FTypeSnapshot::FField>& OutFields)
 	{
-		auto Func = FuncNode->GetTargetFunction();
-		if (Func)
+		for (TFieldIterator<FProperty> PropertyIterator(Struct);
+			 PropertyIterator && (PropertyIterator->PropertyFlags & CPF_BlueprintVisible); ++PropertyIterator)
 		{
-			NodeDocFile->AppendChildWithValueEscaped("funcname", Func->GetAuthoredName());
-			NodeDocFile->AppendChildWithValueEscaped("rawcomment", Func->GetMetaData(TEXT("Comment")));
-			NodeDocFile->AppendChildWithValue("static", Func->HasAnyFunctionFlags(FUNC_Static) ? "true" : "false");
-			NodeDocFile->AppendChildWithValue("autocast",
-											  Func->HasMetaData(TEXT("BlueprintAutocast")) ? "true" : "false");
-			TArray<FStringFormatArg> Args;
+			auto& Field = OutFields.AddDefaulted_GetRef();
+			Field.Name = PropertyIterator->GetNameCPP();
+			FString ExtendedTypeString;
+			FString TypeString = PropertyIterator->GetCPPType(&ExtendedTypeString);
+			Field.Type = TypeString + ExtendedTypeString;
+			Field.Comment = PropertyIterator->GetMetaData(TEXT("Comment"));
+		}
+	}
 
-			if (FProperty* RetProp = Func->GetReturnProperty())
-			{
-				FString ExtendedParameters;
-				FString RetValType = RetProp->GetCPPType(&ExtendedParameters);
-				Args.Add({RetValType + ExtendedParameters});
-			}
-			else
-			{
-				Args.Add({"void"});
-			}
-			Args.Add({Func->GetAuthoredName()});
-			FString FuncParams;
-			for (TFieldIterator<FProperty> PropertyIterator(Func);
-				 PropertyIterator && (PropertyIterator->PropertyFlags & CPF_Parm | CPF_Parm); ++PropertyIterator)
-			{
-				FProperty* FuncParameter = *PropertyIterator;
-
-				// Skip the return type as we handled it earlier
-				if (FuncParameter->HasAllPropertyFlags(CPF_ReturnParm))
-				{
-					continue;
-				}
-
-				FString ExtendedParameters;
-				FString ParamType = FuncParameter->GetCPPType(&ExtendedParameters);
-
-				FString ParamString = ParamType + ExtendedParameters + " " + FuncParameter->GetAuthoredName();
-				if (FuncParams.Len() != 0)
-				{
-					FuncParams.Append(", ");
-				}
-				FuncParams.Append(ParamString);
-			}
-			Args.Add({FuncParams});
-			Args.Add({Func->HasAnyFunctionFlags(FUNC_Const) ? " const" : ""});
-			NodeDocFile->AppendChildWithValueEscaped("rawsignature", FString::Format(TEXT("{0} {1}({2}){3}"), Args));
+	static void AppendFields(TSharedPtr<DocTreeNode> const& MemberList,
+							 TArray<FNodeDocsGenerator::FTypeSnapshot::FField> const& Fields)
+	{
+		// Properties aren't UObjects in every engine version, so their comments aren't cached, just parsed into the
+		// same buffers one after the other
+		Detail::FDoxygenTags Tags;
+		for (auto const& Field : Fields)
+		{
+			auto Member = MemberList->AppendChild(TEXT("field"));
+			Member->AppendChildWithValueEscaped("name", Field.Name);
+			Member->AppendChildWithValueEscaped("type", Field.Type);
+			Detail::ParseDoxygenTags(Field.Comment, Tags);
+			AppendDoxygenTags(Member, Tags);
+		}
+	}
 
-			auto Tags = Detail::ParseDoxygenTagsForString(Func->GetMetaData(TEXT("Comment")));
-			if (Tags.Num())
-			{
-				auto DoxygenElement = NodeDocFile->AppendChild("doxygen");
-				for (auto CurrentTag : Tags)
-				{
-					for (auto CurrentValue : CurrentTag.Value)
-					{
-						DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
-					}
-				}
-			}
+	// Struct and enum docs carry the documentation title, so it is part of the hash
+	static FString HashTypeSnapshot(FNodeDocsGenerator::FTypeSnapshot const& Type, FString const& DocsTitle)
+	{
+		TArray<FString> Parts;
+		Parts.Add(DocsTitle);
+		Parts.Add(FString::Printf(TEXT("%d"), (int32) Type.Kind));
+		Parts.Add(Type.Id);
+		Parts.Add(Type.DisplayName);
+		Parts.Add(Type.Comment);
+		for (auto const& Field : Type.Fields)
+		{
+			Parts.Add(Field.Name);
+			Parts.Add(Field.Type);
+			Parts.Add(Field.Comment);
 		}
-		else
+		for (auto const& Value : Type.Values)
 		{
-			UE_LOG(LogKantanDocGen, Warning, TEXT("[KantanDocGen] Failed to get target function for node %s "), *NodeFullTitle);
+			Parts.Add(Value.Name);
+			Parts.Add(Value.DisplayName);
+			Parts.Add(Value.Description);
 		}
+
+		FTCHARToUTF8 Utf8(*FString::Join(Parts, TEXT("\n")));
+		FMD5 Md5;
+		Md5.Update((const uint8*) Utf8.Get(), Utf8.Length());
+		return FinishHash(Md5);
 	}
-	else
+} // namespace NodeDocsGenerator
+
+FString FNodeDocsGenerator::GT_HashType(FString const& TypePath)
+{
+	if (!TypePath.StartsWith(TEXT("/Script/")))
 	{
-		UE_LOG(LogKantanDocGen, Warning, TEXT("[KantanDocGen] Cannot get type for node %s "),
-			   *NodeFullTitle);
+		auto& AssetRegistry = FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByPackageName(FName(*FPackageName::ObjectPathToPackageName(TypePath)), Assets, true);
+		return Assets.Num() > 0 ? FContentPathEnumerator::GetPackageSignature(Assets[0]) : FString();
 	}
-	auto InputNode = NodeDocFile->AppendChild("inputs");
 
-	for (auto Pin : Node->Pins)
+	// Snapshots include inherited fields, so changes to base classes and structs count too
+	FTypeSnapshot Snapshot;
+	UObject* Type = FindObject<UObject>(nullptr, *TypePath);
+	if (Type == nullptr || !GT_SnapshotType(Type, Snapshot))
 	{
-		if (Pin->Direction == EEdGraphPinDirection::EGPD_Input)
-		{
-			if (ShouldDocumentPin(Pin))
-			{
-				auto Input = InputNode->AppendChild(TEXT("param"));
+		return Type ? Type->GetClass()->GetPathName() : FString();
+	}
+	return NodeDocsGenerator::HashTypeSnapshot(Snapshot, FString());
+}
 
-				FString PinName, PinType, PinDesc;
-				ExtractPinInformation(Pin, PinName, PinType, PinDesc);
+bool FNodeDocsGenerator::GT_SnapshotType(UObject* Type, FTypeSnapshot& OutSnapshot)
+{
+	if (Type == nullptr)
+	{
+		return false;
+	}
 
-				Input->AppendChildWithValueEscaped(TEXT("name"), PinName);
-				Input->AppendChildWithValueEscaped(TEXT("type"), PinType);
-				Input->AppendChildWithValueEscaped(TEXT("description"), PinDesc);
-			}
+	OutSnapshot = FTypeSnapshot();
+	if (Type->GetClass() == UClass::StaticClass())
+	{
+		UClass* ClassInstance = Cast<UClass>(Type);
+		OutSnapshot.Kind = FTypeSnapshot::EKind::Class;
+		OutSnapshot.Id = GetClassDocId(ClassInstance);
+		OutSnapshot.DisplayName = GetClassDisplayName(ClassInstance);
+		NodeDocsGenerator::SnapshotFields(ClassInstance, OutSnapshot.Fields);
+		return true;
+	}
+	else if (Type->GetClass() == UScriptStruct::StaticClass())
+	{
+		UScriptStruct* Struct = Cast<UScriptStruct>(Type);
+		if (Struct->HasAnyFlags(EObjectFlags::RF_ArchetypeObject | EObjectFlags::RF_ClassDefaultObject))
+		{
+			return false;
 		}
+		OutSnapshot.Kind = FTypeSnapshot::EKind::Struct;
+		OutSnapshot.Struct = Struct;
+		OutSnapshot.Id = Struct->GetName();
+		OutSnapshot.DisplayName = Struct->HasMetaData(TEXT("DisplayName"))
+									  ? Struct->GetMetaData(TEXT("DisplayName"))
+									  : FName::NameToDisplayString(Struct->GetName(), false);
+		OutSnapshot.Comment = Struct->GetMetaData(TEXT("Comment"));
+		NodeDocsGenerator::SnapshotFields(Struct, OutSnapshot.Fields);
+		return true;
 	}
-
-	auto OutputNode = NodeDocFile->AppendChild(TEXT("outputs"));
-	for (auto Pin : Node->Pins)
+	else if (Type->GetClass() == UEnum::StaticClass())
 	{
-		if (Pin->Direction == EEdGraphPinDirection::EGPD_Output)
+		UEnum* EnumInstance = Cast<UEnum>(Type);
+		if ((EnumInstance != NULL) && EnumInstance->HasAnyFlags(RF_NeedLoad))
 		{
-			if (ShouldDocumentPin(Pin))
+			EnumInstance->GetLinker()->Preload(EnumInstance);
+		}
+		EnumInstance->ConditionalPostLoad();
+
+		OutSnapshot.Kind = FTypeSnapshot::EKind::Enum;
+		OutSnapshot.Enum = EnumInstance;
+		OutSnapshot.Id = EnumInstance->GetName();
+		OutSnapshot.DisplayName = EnumInstance->HasMetaData(TEXT("DisplayName"))
+									  ? EnumInstance->GetMetaData(TEXT("DisplayName"))
+									  : EnumInstance->GetName();
+		OutSnapshot.Comment = EnumInstance->GetMetaData(TEXT("Comment"));
+		for (int32 EnumIndex = 0; EnumIndex < EnumInstance->NumEnums() - 1; ++EnumIndex)
+		{
+			bool const bShouldBeHidden = EnumInstance->HasMetaData(TEXT("Hidden"), EnumIndex) ||
+										 EnumInstance->HasMetaData(TEXT("Spacer"), EnumIndex);
+			if (!bShouldBeHidden)
 			{
-				auto Output = OutputNode->AppendChild(TEXT("param"));
+				auto& Value = OutSnapshot.Values.AddDefaulted_GetRef();
+				Value.Name = EnumInstance->GetNameStringByIndex(EnumIndex);
+				Value.DisplayName = EnumInstance->GetDisplayNameTextByIndex(EnumIndex).ToString();
+				Value.Description = EnumInstance->GetToolTipTextByIndex(EnumIndex).ToString();
+			}
+		}
+		return true;
+	}
+
+	return false;
+}
 
-				FString PinName, PinType, PinDesc;
-				ExtractPinInformation(Pin, PinName, PinType, PinDesc);
+TSharedPtr<DocTreeNode> FNodeDocsGenerator::BuildTypeDocTree(FTypeSnapshot const& Type)
+{
+	switch (Type.Kind)
+	{
+		case FTypeSnapshot::EKind::Class:
+		{
+			TSharedPtr<DocTreeNode> Fields = MakeShared<DocTreeNode>();
+			NodeDocsGenerator::AppendFields(Fields, Type.Fields);
+			return Fields;
+		}
+		case FTypeSnapshot::EKind::Struct:
+		{
+			auto StructDocTree = InitStructDocTree(Type.Id, Type.DisplayName);
+			NodeDocsGenerator::AppendDoxygenTags(StructDocTree, *GetDoxygenTags(Type.Struct, Type.Comment));
+			NodeDocsGenerator::AppendFields(StructDocTree->FindChildByName("fields"), Type.Fields);
+			return StructDocTree;
+		}
+		case FTypeSnapshot::EKind::Enum:
+		{
+			auto EnumDocTree = InitEnumDocTree(Type.Id, Type.DisplayName);
+			NodeDocsGenerator::AppendDoxygenTags(EnumDocTree, *GetDoxygenTags(Type.Enum, Type.Comment));
 
-				Output->AppendChildWithValueEscaped(TEXT("name"), PinName);
-				Output->AppendChildWithValueEscaped(TEXT("type"), PinType);
-				Output->AppendChildWithValueEscaped(TEXT("description"), PinDesc);
+			auto ValueList = EnumDocTree->FindChildByName("values");
+			for (auto const& EnumValue : Type.Values)
+			{
+				auto Value = ValueList->AppendChild("value");
+				Value->AppendChildWithValueEscaped("name", EnumValue.Name);
+				Value->AppendChildWithValueEscaped("displayname", EnumValue.DisplayName);
+				Value->AppendChildWithValueEscaped("description", EnumValue.Description);
 			}
+			return EnumDocTree;
 		}
 	}
+	return nullptr;
+}
 
-	for (const auto& FactoryObject : OutputFormats)
+bool FNodeDocsGenerator::GenerateTypeMembers(FTypeSnapshot const& Type)
+{
+	UE_LOG(LogKantanDocGen, Display, TEXT("generating type members for : %s"), *Type.Id);
+
+	// Mostly doxygen parsing, which the derived data cache can spare us for types documented before
+	FString TypeHash;
+	TSharedPtr<DocTreeNode> TypeDocTree;
+	if (DerivedData)
 	{
-		auto Serializer = FactoryObject->CreateSerializer();
-		NodeDocFile->SerializeWith(Serializer);
-		Serializer->SaveToFile(NodeDocsPath, GetNodeDocId(Node));
+		TypeHash = NodeDocsGenerator::HashTypeSnapshot(Type, DocsTitle);
+		TypeDocTree = DerivedData->GetDocTree(NodeDocsGenerator::TypeDocKind, TypeHash);
 	}
-
-	if (!UpdateClassDocWithNode(State.ClassDocTree, Node))
+	if (!TypeDocTree.IsValid())
 	{
-		return false;
+		TypeDocTree = BuildTypeDocTree(Type);
+		if (DerivedData)
+		{
+			DerivedData->PutDocTree(NodeDocsGenerator::TypeDocKind, TypeHash, TypeDocTree);
+		}
 	}
 
-	return true;
-}
-
-bool FNodeDocsGenerator::GenerateTypeMembers(UObject* Type)
-{
-	if (Type)
+	switch (Type.Kind)
 	{
-		UE_LOG(LogKantanDocGen, Display, TEXT("generating type members for : %s"), *Type->GetName());
-		if (Type->GetClass() == UClass::StaticClass())
+		case FTypeSnapshot::EKind::Class:
 		{
-			UClass* ClassInstance = Cast<UClass>(Type);
-			TSharedPtr<DocTreeNode>* FoundClassDocTree = ClassDocTreeMap.Find(ClassInstance);
+			// Classes with nodes already have a doc tree in the map, so only touch it under the lock
+			FScopeLock Lock(&DocTreeLock);
 			TSharedPtr<DocTreeNode> ClassDocTree;
-			if (!FoundClassDocTree)
+			bool bFoundClassDocTree = false;
+			if (TSharedPtr<DocTreeNode>* FoundClassDocTree = ClassDocTreeMap.Find(Type.Id))
 			{
-				ClassDocTree = InitClassDocTree(ClassInstance);
+				ClassDocTree = *FoundClassDocTree;
+				bFoundClassDocTree = true;
 			}
 			else
 			{
-				ClassDocTree = *FoundClassDocTree;
+				ClassDocTree = InitClassDocTree(Type.Id, Type.DisplayName);
 			}
-			bool bClassShouldBeDocumented = false;
-			auto MemberList = ClassDocTree->FindChildByName("fields");
-			for (TFieldIterator<FProperty> PropertyIterator(ClassInstance);
-				 PropertyIterator && (PropertyIterator->PropertyFlags & CPF_BlueprintVisible); ++PropertyIterator)
+			if (Type.Fields.Num() > 0)
 			{
-				bClassShouldBeDocumented = true;
-				UE_LOG(LogKantanDocGen, Display, TEXT("member for class found : %s"), *PropertyIterator->GetNameCPP());
-				auto Member = MemberList->AppendChild(TEXT("field"));
-				Member->AppendChildWithValueEscaped("name", PropertyIterator->GetNameCPP());
-				FString ExtendedTypeString;
-				FString TypeString = PropertyIterator->GetCPPType(&ExtendedTypeString);
-				Member->AppendChildWithValueEscaped("type", TypeString + ExtendedTypeString);
-				auto MemberTags = Detail::ParseDoxygenTagsForString(PropertyIterator->GetMetaData(TEXT("Comment")));
-				if (MemberTags.Num())
-				{
-					auto DoxygenElement = Member->AppendChild("doxygen");
-					for (auto CurrentTag : MemberTags)
-					{
-						for (auto CurrentValue : CurrentTag.Value)
-						{
-							DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
-						}
-					}
-				}
+				ClassDocTree->FindChildByName("fields")->AppendChildrenOf(*TypeDocTree);
 			}
 
 			// Only insert this into the map of classdocs if it wasnt already in there, and we actually need it to be
 			// included
-			if (!FoundClassDocTree && bClassShouldBeDocumented)
+			if (!bFoundClassDocTree && Type.Fields.Num() > 0)
 			{
-				ClassDocTreeMap.Add(ClassInstance, ClassDocTree);
-				UpdateIndexDocWithClass(IndexTree, ClassInstance);
+				ClassDocTreeMap.Add(Type.Id, ClassDocTree);
+				UpdateIndexDocWithClass(IndexTree, Type.Id, Type.DisplayName);
 			}
+			break;
 		}
-		else if (Type->GetClass() == UScriptStruct::StaticClass())
+		case FTypeSnapshot::EKind::Struct:
 		{
-			UScriptStruct* Struct = Cast<UScriptStruct>(Type);
-			if (!Struct->HasAnyFlags(EObjectFlags::RF_ArchetypeObject | EObjectFlags::RF_ClassDefaultObject))
-			{
-				auto StructDocTree = InitStructDocTree(Struct);
-				auto MemberList = StructDocTree->FindChildByName("fields");
-
-				auto StructTags = Detail::ParseDoxygenTagsForString(Struct->GetMetaData(TEXT("Comment")));
-				if (StructTags.Num())
-				{
-					auto DoxygenElement = StructDocTree->AppendChild("doxygen");
-					for (auto CurrentTag : StructTags)
-					{
-						for (auto CurrentValue : CurrentTag.Value)
-						{
-							DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
-						}
-					}
-				}
-
-				for (TFieldIterator<FProperty> PropertyIterator(Struct);
-					 PropertyIterator && (PropertyIterator->PropertyFlags & CPF_BlueprintVisible); ++PropertyIterator)
-				{
-					// Move into its own function for use in parsing classes
-					auto Member = MemberList->AppendChild("field");
-					Member->AppendChildWithValueEscaped("name", PropertyIterator->GetNameCPP());
-					FString ExtendedTypeString;
-					FString TypeString = PropertyIterator->GetCPPType(&ExtendedTypeString);
-
-					Member->AppendChildWithValueEscaped("type", TypeString + ExtendedTypeString);
-					auto MemberTags = Detail::ParseDoxygenTagsForString(PropertyIterator->GetMetaData(TEXT("Comment")));
-					if (MemberTags.Num())
-					{
-						auto DoxygenElement = Member->AppendChild("doxygen");
-						for (auto CurrentTag : MemberTags)
-						{
-							for (auto CurrentValue : CurrentTag.Value)
-							{
-								DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
-							}
-						}
-					}
-				}
-
-				StructDocTreeMap.Add(Struct, StructDocTree);
-				UpdateIndexDocWithStruct(IndexTree, Struct);
-			}
+			FScopeLock Lock(&DocTreeLock);
+			StructDocTreeMap.Add(Type.Struct, TypeDocTree);
+			UpdateIndexDocWithStruct(IndexTree, Type.Id, Type.DisplayName);
+			break;
 		}
-		else if (Type->GetClass() == UEnum::StaticClass())
+		case FTypeSnapshot::EKind::Enum:
 		{
-			UEnum* EnumInstance = Cast<UEnum>(Type);
-			if ((EnumInstance != NULL) && EnumInstance->HasAnyFlags(RF_NeedLoad))
-			{
-				EnumInstance->GetLinker()->Preload(EnumInstance);
-			}
-			EnumInstance->ConditionalPostLoad();
-
-			auto EnumDocTree = InitEnumDocTree(EnumInstance);
-			auto EnumTags = Detail::ParseDoxygenTagsForString(EnumInstance->GetMetaData(TEXT("Comment")));
-			if (EnumTags.Num())
-			{
-				auto DoxygenElement = EnumDocTree->AppendChild("doxygen");
-				for (auto CurrentTag : EnumTags)
-				{
-					for (auto CurrentValue : CurrentTag.Value)
-					{
-						DoxygenElement->AppendChildWithValueEscaped(CurrentTag.Key, CurrentValue);
-					}
-				}
-			}
-
-			auto ValueList = EnumDocTree->FindChildByName("values");
-			for (int32 EnumIndex = 0; EnumIndex < EnumInstance->NumEnums() - 1; ++EnumIndex)
-			{
-				bool const bShouldBeHidden = EnumInstance->HasMetaData(TEXT("Hidden"), EnumIndex) ||
-											 EnumInstance->HasMetaData(TEXT("Spacer"), EnumIndex);
-				if (!bShouldBeHidden)
-				{
-					auto Value = ValueList->AppendChild("value");
-					Value->AppendChildWithValueEscaped("name", EnumInstance->GetNameStringByIndex(EnumIndex));
-					Value->AppendChildWithValueEscaped("displayname",
-													   EnumInstance->GetDisplayNameTextByIndex(EnumIndex).ToString());
-					Value->AppendChildWithValueEscaped("description",
-													   EnumInstance->GetToolTipTextByIndex(EnumIndex).ToString());
-				}
-			}
-			UpdateIndexDocWithEnum(IndexTree, EnumInstance);
-			EnumDocTreeMap.Add(EnumInstance, EnumDocTree);
+			FScopeLock Lock(&DocTreeLock);
+			UpdateIndexDocWithEnum(IndexTree, Type.Id, Type.DisplayName);
+			EnumDocTreeMap.Add(Type.Enum, TypeDocTree);
+			break;
 		}
 	}
 
@@ -722,28 +1532,92 @@ bool FNodeDocsGenerator::SaveClassDocFile(FString const& OutDir)
 {
 	for (const auto& Entry : ClassDocTreeMap)
 	{
-		auto ClassId = GetClassDocId(Entry.Key.Get());
-		auto Path = OutDir / ClassId;
-		auto DummyImagePath = OutDir / ClassId / "img";
-		if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
+		SaveClassDoc(OutDir, Entry.Key, Entry.Value);
+	}
+	return true;
+}
+
+bool FNodeDocsGenerator::SaveClassDoc(FString const& OutDir, FString const& ClassId, TSharedPtr<DocTreeNode> DocTree)
+{
+	auto Path = OutDir / ClassId;
+	if (Manifest)
+	{
+		FMD5 Md5;
+		DocTree->UpdateHash(Md5);
+		FString const Hash = NodeDocsGenerator::FinishHash(Md5);
+		// The files written by the manifest's run are still current
+		bool const bUnchanged = Manifest->IsClassUnchanged(ClassId, Hash) && IFileManager::Get().DirectoryExists(*Path);
+		Manifest->RecordClass(ClassId, Hash);
+		if (bUnchanged)
 		{
-			IFileManager::Get().MakeDirectory(*DummyImagePath);
+			return true;
 		}
-		for (const auto& FactoryObject : OutputFormats)
+	}
+	auto DummyImagePath = OutDir / ClassId / "img";
+	if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
+	{
+		IFileManager::Get().MakeDirectory(*DummyImagePath);
+	}
+	for (const auto& FactoryObject : OutputFormats)
+	{
+		auto Serializer = FactoryObject->CreateSerializer();
+		DocTree->SerializeWith(Serializer);
+		Serializer->SaveToFile(Path, ClassId);
+	}
+	return true;
+}
+
+void FNodeDocsGenerator::RemoveStaleFiles(FString const& OutDir)
+{
+	if (Manifest == nullptr)
+	{
+		return;
+	}
+
+	IFileManager& FileManager = IFileManager::Get();
+	for (FString const& NodeKey : Manifest->GetPreviousNodeKeys())
+	{
+		FString ClassId, NodeId;
+		if (DocumentedNodeKeys.Contains(NodeKey) || !NodeKey.Split(TEXT("/"), &ClassId, &NodeId))
 		{
-			auto Serializer = FactoryObject->CreateSerializer();
-			Entry.Value->SerializeWith(Serializer);
-			Serializer->SaveToFile(Path, ClassId);
+			continue;
+		}
+		// One file per output format, all named after the node
+		FString const NodeDocsPath = OutDir / ClassId / TEXT("nodes");
+		TArray<FString> NodeFiles;
+		FileManager.FindFiles(NodeFiles, *(NodeDocsPath / NodeId + TEXT(".*")), true, false);
+		for (FString const& NodeFile : NodeFiles)
+		{
+			FileManager.Delete(*(NodeDocsPath / NodeFile), false, true, true);
+		}
+		FileManager.Delete(*(OutDir / ClassId / TEXT("img") / FString::Printf(TEXT("nd_img_%s.png"), *NodeId)), false,
+						   true, true);
+	}
+	for (FString const& ClassId : Manifest->GetPreviousClassIds())
+	{
+		if (!ClassDocTreeMap.Contains(ClassId))
+		{
+			FileManager.DeleteDirectory(*(OutDir / ClassId), false, true);
 		}
 	}
-	return true;
+}
+
+bool FNodeDocsGenerator::PublishClassDoc(FString const& ClassId)
+{
+	FScopeLock Lock(&DocTreeLock);
+	if (auto DocTree = ClassDocTreeMap.Find(ClassId))
+	{
+		return SaveClassDoc(OutputDir, ClassId, *DocTree);
+	}
+	return false;
 }
 
 bool FNodeDocsGenerator::SaveEnumDocFile(FString const& OutDir)
 {
 	for (const auto& Entry : EnumDocTreeMap)
 	{
-		auto EnumId = Entry.Key.Get()->GetName();
+		// Read from the doc tree rather than the enum, which may only be touched on the game thread
+		auto EnumId = Entry.Value->FindChildByName(TEXT("id"))->GetValue();
 		auto Path = OutDir / EnumId;
 		auto DummyImagePath = OutDir / EnumId / "img";
 		if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
@@ -764,7 +1638,7 @@ bool FNodeDocsGenerator::SaveStructDocFile(FString const& OutDir)
 {
 	for (const auto& Entry : StructDocTreeMap)
 	{
-		auto StructId = Entry.Key.Get()->GetName();
+		auto StructId = Entry.Value->FindChildByName(TEXT("id"))->GetValue();
 		auto Path = OutDir / StructId;
 		auto DummyImagePath = OutDir / StructId / "img";
 		if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
@@ -799,16 +1673,38 @@ FString FNodeDocsGenerator::GetClassDocId(UClass* Class)
 	return Class->GetName();
 }
 
+FString FNodeDocsGenerator::GT_GetSourceClassDocId(UObject* SourceObject)
+{
+	// Matches the fallback of MapToAssociatedClass
+	UClass* Class = Cast<UClass>(SourceObject);
+	if (auto SourceBP = Cast<UBlueprint>(SourceObject))
+	{
+		Class = SourceBP->GeneratedClass;
+	}
+	return Class ? GetClassDocId(Class) : FString();
+}
+
+FString FNodeDocsGenerator::GetClassDisplayName(UClass* Class)
+{
+	return FBlueprintEditorUtils::GetFriendlyClassDisplayName(Class).ToString();
+}
+
 FString FNodeDocsGenerator::GetNodeDocId(UEdGraphNode* Node)
 {
 	// @TODO: Not sure this is right thing to use
 	return Node->GetDocumentationExcerptName();
 }
 
+FString FNodeDocsGenerator::MakeNodeKey(FString const& ClassId, FString const& NodeId)
+{
+	return ClassId / NodeId;
+}
+
 #include "BlueprintDelegateNodeSpawner.h"
 #include "BlueprintVariableNodeSpawner.h"
 #include "K2Node_CallFunction.h"
 #include "K2Node_DynamicCast.h"
+#include "K2Node_Event.h"
 
 /*
 This takes a graph node object and attempts to map it to the class which the node conceptually belong to.
@@ -841,8 +1737,13 @@ UClass* FNodeDocsGenerator::MapToAssociatedClass(UK2Node* NodeInst, UObject* Sou
 	}
 }
 
-bool FNodeDocsGenerator::IsSpawnerDocumentable(UBlueprintNodeSpawner* Spawner, bool bIsBlueprint)
+uint8 FNodeDocsGenerator::GetClassExclusionFlags(UClass* Class)
 {
+	if (auto Flags = ClassExclusionFlags.Find(Class))
+	{
+		return *Flags;
+	}
+
 	// Spawners of or deriving from the following classes will be excluded
 	static const TSubclassOf<UBlueprintNodeSpawner> ExcludedSpawnerClasses[] = {
 		UBlueprintVariableNodeSpawner::StaticClass(),
@@ -860,40 +1761,56 @@ bool FNodeDocsGenerator::IsSpawnerDocumentable(UBlueprintNodeSpawner* Spawner, b
 	static const TSubclassOf<UK2Node> ExcludedNodeClasses[] = {
 		UK2Node_DynamicCast::StaticClass(),
 		UK2Node_Message::StaticClass(),
+		// Events are never documented, so don't spend time spawning and rendering them
+		UK2Node_Event::StaticClass(),
 	};
 
-	// Function spawners for functions with any of the following metadata tags will also be excluded
-	static const FName ExcludedFunctionMeta[] = {TEXT("BlueprintAutocast")};
-
-	static const uint32 PermittedAccessSpecifiers = (FUNC_Public | FUNC_Protected);
-
+	uint8 Flags = 0;
 	for (auto ExclSpawnerClass : ExcludedSpawnerClasses)
 	{
-		if (Spawner->IsA(ExclSpawnerClass))
+		if (Class->IsChildOf(ExclSpawnerClass))
 		{
-			return false;
+			Flags |= EClassExclusion::Always;
 		}
 	}
-
-	if (bIsBlueprint)
+	for (auto ExclSpawnerClass : BlueprintOnlyExcludedSpawnerClasses)
 	{
-		for (auto ExclSpawnerClass : BlueprintOnlyExcludedSpawnerClasses)
+		if (Class->IsChildOf(ExclSpawnerClass))
 		{
-			if (Spawner->IsA(ExclSpawnerClass))
-			{
-				return false;
-			}
+			Flags |= EClassExclusion::InBlueprint;
 		}
 	}
-
 	for (auto ExclNodeClass : ExcludedNodeClasses)
 	{
-		if (Spawner->NodeClass->IsChildOf(ExclNodeClass))
+		if (Class->IsChildOf(ExclNodeClass))
 		{
-			return false;
+			Flags |= EClassExclusion::Always;
 		}
 	}
 
+	ClassExclusionFlags.Add(Class, Flags);
+	return Flags;
+}
+
+bool FNodeDocsGenerator::IsSpawnerDocumentable(UBlueprintNodeSpawner* Spawner, bool bIsBlueprint)
+{
+	// Function spawners for functions with any of the following metadata tags will also be excluded
+	static const FName ExcludedFunctionMeta[] = {TEXT("BlueprintAutocast")};
+
+	static const uint32 PermittedAccessSpecifiers = (FUNC_Public | FUNC_Protected);
+
+	// Spawner and node class exclusions only depend on the class, so are worked out once per class
+	uint8 const SpawnerExclusionMask = bIsBlueprint ? (EClassExclusion::Always | EClassExclusion::InBlueprint)
+													: EClassExclusion::Always;
+	if ((GetClassExclusionFlags(Spawner->GetClass()) & SpawnerExclusionMask) != 0)
+	{
+		return false;
+	}
+	if (Spawner->NodeClass && (GetClassExclusionFlags(Spawner->NodeClass) & EClassExclusion::Always) != 0)
+	{
+		return false;
+	}
+
 	if (auto FuncSpawner = Cast<UBlueprintFunctionNodeSpawner>(Spawner))
 	{
 		auto Func = FuncSpawner->GetFunction();
@@ -7,8 +7,12 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Containers/Queue.h"
 #include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
 #include "GameFramework/Actor.h"
+#include "HAL/CriticalSection.h"
+#include "Runtime/ImageWriteQueue/Public/ImageWriteTask.h"
 
 
 class UClass;
@@ -18,6 +22,13 @@ class UEdGraphNode;
 class UK2Node;
 class UBlueprintNodeSpawner;
 class FXmlFile;
+class FDocGenManifest;
+class FDocGenImageCache;
+class FDocGenDerivedData;
+namespace Detail
+{
+	struct FDoxygenTags;
+}
 
 class FNodeDocsGenerator
 {
@@ -28,73 +39,357 @@ public:
 	~FNodeDocsGenerator();
 
 public:
+	/*
+	Everything needed to list an already documented node in a class doc, and optionally to write its files to another
+	output location.
+	*/
+	struct FDocumentedNode
+	{
+		FString ClassId;
+		FString ClassDisplayName;
+		FString NodeId;
+		FString ShortTitle;
+		// Absolute path of the written node image
+		FString ImageFile;
+		// Node doc contents, excluding the per-documentation 'docs_name' field
+		TSharedPtr<class DocTreeNode> NodeDocBody;
+	};
+
+	/*
+	Keeps a spawned node alive while it moves through the pipeline. Once released, from whichever thread, the node is
+	handed back to the generator to be removed from its graph and destroyed on the game thread.
+	*/
+	class FNodeLease
+	{
+	public:
+		FNodeLease(FNodeDocsGenerator& InOwner, UK2Node* InNode);
+		~FNodeLease();
+
+	private:
+		FNodeDocsGenerator& Owner;
+		UK2Node* Node;
+	};
+
+	/*
+	Plain copy of the reflection data a type's docs are built from. Captured on the game thread, after which the docs
+	can be built on any thread.
+	*/
+	struct FTypeSnapshot
+	{
+		enum class EKind : uint8
+		{
+			Class,
+			Struct,
+			Enum,
+		};
+
+		struct FField
+		{
+			FString Name;
+			FString Type;
+			FString Comment;
+		};
+
+		struct FEnumValue
+		{
+			FString Name;
+			FString DisplayName;
+			FString Description;
+		};
+
+		EKind Kind = EKind::Class;
+		// Only used as map keys, never dereferenced off the game thread
+		TWeakObjectPtr<UStruct> Struct;
+		TWeakObjectPtr<UEnum> Enum;
+		FString Id;
+		FString DisplayName;
+		FString Comment;
+		TArray<FField> Fields;
+		TArray<FEnumValue> Values;
+	};
+
+	/*
+	Everything the node docs, image file name and node hash are made from. Read from the node once on the game
+	thread, since titles, tooltips and pin hover text are built afresh by the node each time they are asked for,
+	and so that the encode and serialize workers never touch the node or its function.
+	*/
+	struct FNodeSnapshot
+	{
+		struct FPin
+		{
+			EEdGraphPinDirection Direction = EGPD_Input;
+			FString Name;
+			FString Type;
+			FString Description;
+		};
+
+		// Only set for function call nodes with a target function
+		struct FFunction
+		{
+			FString Name;
+			FString Comment;
+			// Return type, name, parameters and constness, as declared in C++
+			FString Signature;
+			bool bStatic = false;
+			bool bAutocast = false;
+			TSharedPtr<Detail::FDoxygenTags const, ESPMode::ThreadSafe> DoxygenTags;
+		};
+
+		FString ClassId;
+		FString ClassDisplayName;
+		FString NodeId;
+		FString ShortTitle;
+		// Without the 'Target is' suffix
+		FString FullTitle;
+		// Tooltip, without the 'Target is' suffix
+		FString Description;
+		FString Category;
+		// Documented pins only, in node order
+		TArray<FPin> Pins;
+		TOptional<FFunction> Function;
+		bool bIsFunctionCall = false;
+	};
+
 	struct FNodeProcessingState
 	{
+		// Where the node image comes from
+		enum class EImageSource : uint8
+		{
+			Render,
+			ImageCache,
+			DerivedData,
+		};
+
 		TSharedPtr<class DocTreeNode> ClassDocTree;
 		FString ClassDocsPath;
 		FString RelImageBasePath;
 		FString ImageFilename;
+		// Rendered node image, held between rendering on the game thread and encoding in the background
+		TUniquePtr<FImagePixelData> PixelData;
+		// Filled in once the node docs have been written
+		FDocumentedNode Documented;
+		// Content hash of the node, taken when it is spawned. Recorded in the manifest once its docs are written.
+		FString NodeHash;
+		// Hash of what the node image is rendered from
+		FString ImageCacheKey;
+		EImageSource ImageSource;
+		FNodeSnapshot Snapshot;
 
 		FNodeProcessingState():
 			ClassDocTree()
 			, ClassDocsPath()
 			, RelImageBasePath()
 			, ImageFilename()
+			, PixelData()
+			, Documented()
+			, NodeHash()
+			, ImageCacheKey()
+			, ImageSource(EImageSource::Render)
+			, Snapshot()
 		{}
 	};
 
+	/** A node whose image is to be rendered as part of a batch */
+	struct FNodeImageJob
+	{
+		UEdGraphNode* Node = nullptr;
+		FNodeProcessingState* State = nullptr;
+		// Set once the image is in State, or known to be in a cache
+		bool bRendered = false;
+		// False to render the node even though its image was thought to be cached
+		bool bUseCaches = true;
+	};
+
+	enum class ESaveImageResult : uint8
+	{
+		Saved,
+		Failed,
+		// The cached image has gone since it was looked up, or was never there, so the node has to be rendered
+		// after all
+		NeedsRender,
+	};
+
 public:
+	/** Records what is generated in Manifest, and skips nodes and class docs unchanged since the run it loaded */
+	void SetManifest(FDocGenManifest* InManifest);
+	/** Reuses node images rendered by earlier runs, and adds those rendered by this one */
+	void SetImageCache(FDocGenImageCache* InImageCache);
+	/** Takes node images and doc trees from the derived data cache where it has them, and adds the rest */
+	void SetDerivedData(FDocGenDerivedData* InDerivedData);
+
 	/** Callable only from game thread */
 	bool GT_Init(FString const& InDocsTitle, FString const& InOutputDir, UClass* BlueprintContextClass = AActor::StaticClass());
+	/** Cheap check, before anything is spawned, that a spawner can produce a node not yet documented this run */
+	bool GT_ShouldSpawn(UBlueprintNodeSpawner* Spawner, UObject* SourceObject);
+	/** Spawns the node of a spawner that passed GT_ShouldSpawn. Null if it failed or was already documented. */
 	UK2Node* GT_InitializeForSpawner(UBlueprintNodeSpawner* Spawner, UObject* SourceObject, FNodeProcessingState& OutState);
-	bool GT_Finalize(FString OutputPath);
+	/**
+	 * Gives up a node from GT_InitializeForSpawner that another task is documenting instead, so that its result can
+	 * still be registered once it arrives.
+	 */
+	void GT_DiscardSpawnedNode(UK2Node* Node, FNodeProcessingState const& State);
+	/**
+	 * If the manifest has the node's hash from the last run, the node's files are still current, so the node is just
+	 * listed in its class doc and OutNode describes it.
+	 */
+	bool GT_CheckUnchanged(FNodeProcessingState const& State, FDocumentedNode& OutNode);
+	/** Records the structs, enums and classes shown by the node's pins, whose changes the node hash can't see */
+	void GT_RecordNodeDependencies(UK2Node* Node, FNodeProcessingState const& State);
+	/**
+	 * Hash of a type that docs depend on, empty if it no longer exists. Native types are hashed from a snapshot of
+	 * them; content types from their package's asset registry signature, so they needn't be loaded.
+	 */
+	static FString GT_HashType(FString const& TypePath);
+	bool GT_RenderNodeImage(UEdGraphNode* Node, FNodeProcessingState& State);
+	/**
+	 * Renders the images of a batch of nodes. Those not already cached are laid out side by side in shared atlases,
+	 * so that the render thread is flushed and read back once per atlas rather than once per node.
+	 */
+	void GT_RenderNodeImages(TArrayView<FNodeImageJob> Jobs);
+	/** Destroys the nodes released since the last call, and any dummy graph left with no nodes in use */
+	void GT_ReleaseRetiredNodes();
+	/** Captures what GenerateTypeMembers needs from Type. Returns false if Type doesn't get type docs. */
+	static bool GT_SnapshotType(UObject* Type, FTypeSnapshot& OutSnapshot);
+	/** Id of the class doc that a source object's own nodes are listed in */
+	static FString GT_GetSourceClassDocId(UObject* SourceObject);
 	/**/
 
-	/** Callable from background thread */
-	bool GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingState& State);
-	bool GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState& State);
-	bool GenerateTypeMembers(UObject* Type);
+	/** Identifies a node across runs and documentation sets */
+	static FString MakeNodeKey(FString const& ClassId, FString const& NodeId);
+
+	/**
+	 * Callable from background thread.
+	 * GenerateNodeDocTree and GenerateTypeMembers may be called from several threads at once.
+	 */
+	ESaveImageResult SaveNodeImage(FNodeProcessingState& State);
+	bool GenerateNodeDocTree(FNodeProcessingState& State);
+	bool GenerateTypeMembers(FTypeSnapshot const& Type);
+	/** Adds a node documented elsewhere to its class doc, writing its image and doc files if the node has a body */
+	bool RegisterDocumentedNode(FDocumentedNode const& Node);
+	/** Writes a single class doc as it stands, ahead of Finalize. Returns false if the class has no doc. */
+	bool PublishClassDoc(FString const& ClassId);
+	/** Writes the class, struct, enum and index docs. Only touches doc trees, so needs nothing from the game thread. */
+	bool Finalize(FString const& OutputPath);
+	/** Hands back a spawned node that won't be going through the pipeline, to be destroyed on the game thread */
+	void RetireNode(UK2Node* Node);
 	/**/
 
 protected:
 	void CleanUp();
+	// Game thread only
+	void GT_DestroyNode(UEdGraphNode* Node);
+	void GT_SnapshotNode(UK2Node* Node, FNodeSnapshot& OutSnapshot);
+	/** Type text of a pin, memoized per run since the same few pin types make up most pins */
+	FString const& GT_GetPinTypeText(FEdGraphPinType const& PinType);
+	static FString GT_HashNode(UK2Node* Node, FNodeSnapshot const& Snapshot);
+	static FString GT_HashNodeImage(UEdGraphNode* Node);
+	/**
+	 * Marks the jobs whose node image can be taken from the image cache or derived data, rather than rendered.
+	 * Derived data is asked about the whole batch at once, since each question may be a round trip to a shared DDC.
+	 */
+	void GT_FindCachedNodeImages(TArrayView<FNodeImageJob> Jobs);
+	bool GT_CreateGraph();
+	static void GT_DestroyGraph(UEdGraph* OldGraph);
 	bool SaveIndexFile(FString const& OutDir);
 	bool SaveClassDocFile(FString const& OutDir);
+	// Caller must hold DocTreeLock
+	bool SaveClassDoc(FString const& OutDir, FString const& ClassId, TSharedPtr<DocTreeNode> DocTree);
+	// Deletes the files of nodes and classes the manifest's last run documented but this run didn't.
+	// Caller must hold DocTreeLock.
+	void RemoveStaleFiles(FString const& OutDir);
 	bool SaveEnumDocFile(FString const& OutDir);
 	bool SaveStructDocFile(FString const& OutDir);
 
+	// Everything in a node doc except 'docs_name'
+	TSharedPtr<DocTreeNode> BuildNodeDocBody(FNodeProcessingState const& State);
+	// Class fields, or the whole struct or enum doc
+	TSharedPtr<DocTreeNode> BuildTypeDocTree(FTypeSnapshot const& Type);
+	/** Doxygen tags of a function, struct or enum comment, parsed once per run. Callable from any thread. */
+	TSharedRef<Detail::FDoxygenTags const, ESPMode::ThreadSafe> GetDoxygenTags(TWeakObjectPtr<UObject> Owner,
+																			  FString const& Comment);
 	TSharedPtr<DocTreeNode> InitIndexDocTree(FString const& IndexTitle);
-	TSharedPtr<DocTreeNode> InitClassDocTree(UClass* Class);
-	TSharedPtr<DocTreeNode> InitStructDocTree(UScriptStruct* Struct);
-	TSharedPtr<DocTreeNode> InitEnumDocTree(UEnum* Enum);
-	bool UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree, UClass* Class);
-	bool UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTree, UStruct* Struct);
-	bool UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree, UEnum* Enum);
-	bool UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, UEdGraphNode* Node);
+	TSharedPtr<DocTreeNode> InitClassDocTree(FString const& ClassId, FString const& ClassDisplayName);
+	TSharedPtr<DocTreeNode> InitStructDocTree(FString const& StructId, FString const& DisplayName);
+	TSharedPtr<DocTreeNode> InitEnumDocTree(FString const& EnumId, FString const& DisplayName);
+	bool UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree, FString const& ClassId,
+								 FString const& ClassDisplayName);
+	bool UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTree, FString const& StructId,
+								  FString const& DisplayName);
+	bool UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree, FString const& EnumId, FString const& DisplayName);
+	bool UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, FString const& NodeId, FString const& ShortTitle);
+	// Caller must hold DocTreeLock
+	TSharedPtr<DocTreeNode> FindOrAddClassDocTree(FString const& ClassId, FString const& ClassDisplayName);
+	bool SaveNodeDocFile(FString const& ClassDocsPath, FString const& NodeId, TSharedPtr<DocTreeNode> NodeDocBody);
 	
 	static void AdjustNodeForSnapshot(UEdGraphNode* Node);
 	static FString GetClassDocId(UClass* Class);
+	static FString GetClassDisplayName(UClass* Class);
 	static FString GetNodeDocId(UEdGraphNode* Node);
 	static UClass* MapToAssociatedClass(UK2Node* NodeInst, UObject* Source);
-	static bool IsSpawnerDocumentable(UBlueprintNodeSpawner* Spawner, bool bIsBlueprint);
+	bool IsSpawnerDocumentable(UBlueprintNodeSpawner* Spawner, bool bIsBlueprint);
+	uint8 GetClassExclusionFlags(UClass* Class);
+
+	struct FPinTypeKeyFuncs : BaseKeyFuncs<TPair<FEdGraphPinType, FString>, FEdGraphPinType>
+	{
+		static FEdGraphPinType const& GetSetKey(TPair<FEdGraphPinType, FString> const& Element);
+		static bool Matches(FEdGraphPinType const& A, FEdGraphPinType const& B);
+		static uint32 GetKeyHash(FEdGraphPinType const& Key);
+	};
+
+	// Why spawners of, or for nodes of, a class are excluded
+	struct EClassExclusion
+	{
+		enum Type : uint8
+		{
+			Always = 1 << 0,
+			InBlueprint = 1 << 1,
+		};
+	};
 
 protected:
 	TWeakObjectPtr< UBlueprint > DummyBP;
 	TWeakObjectPtr< UEdGraph > Graph;
 	TSharedPtr< class SGraphPanel > GraphPanel;
+	// Game thread only. Nodes are spawned into Graph until it has had its share, then into a fresh one; earlier
+	// graphs are destroyed once none of their nodes are still in use.
+	int32 NodesSpawnedIntoGraph = 0;
+	TMap<TWeakObjectPtr<UEdGraph>, int32> LiveNodesPerGraph;
+	TQueue<UK2Node*, EQueueMode::Mpsc> RetiredNodes;
 
 	FString DocsTitle;
 	TSharedPtr<DocTreeNode> IndexTree;
-	TMap<TWeakObjectPtr<UClass>, TSharedPtr<DocTreeNode>> ClassDocTreeMap;
+	// Keyed on class doc id, since nodes registered from elsewhere may not have a loaded class
+	TMap<FString, TSharedPtr<DocTreeNode>> ClassDocTreeMap;
 	TMap<TWeakObjectPtr<UStruct>, TSharedPtr<DocTreeNode>> StructDocTreeMap;
 	TMap<TWeakObjectPtr<UEnum>, TSharedPtr<DocTreeNode>> EnumDocTreeMap;
 	TArray<UDocGenOutputFormatFactoryBase*> OutputFormats;
 	FString OutputDir;
+	// Game thread only. EClassExclusion flags of the spawner and node classes seen so far.
+	TMap<UClass*, uint8> ClassExclusionFlags;
+	// Game thread only. Keys (associated class and node doc id) of the nodes spawned so far, so that later function
+	// spawners for them can be skipped. Unlike DocumentedNodeKeys, nodes documented by another task stay in.
+	TSet<FString> SpawnedNodeKeys;
+	// Game thread only. Text of every pin type seen so far.
+	TMap<FEdGraphPinType, FString, FDefaultSetAllocator, FPinTypeKeyFuncs> PinTypeTextCache;
+	// Class and node doc ids of every node spawned or registered
+	TSet<FString> DocumentedNodeKeys;
+	// Optional, not owned
+	FDocGenManifest* Manifest = nullptr;
+	FDocGenImageCache* ImageCache = nullptr;
+	FDocGenDerivedData* DerivedData = nullptr;
+	// Keyed on the function, struct or enum the comment belongs to
+	TMap<TWeakObjectPtr<UObject>, TSharedRef<Detail::FDoxygenTags const, ESPMode::ThreadSafe>> DoxygenTagsCache;
+	FCriticalSection DoxygenTagsCacheLock;
+	// Guards the doc tree maps, the index tree, the node lists of the class doc trees and DocumentedNodeKeys
+	FCriticalSection DocTreeLock;
 	bool SaveAllFormats(FString const& OutDir, TSharedPtr<DocTreeNode> Document){ return false; };
 public:
 	//
-	double GenerateNodeImageTime = 0.0;
 	double GenerateNodeDocsTime = 0.0;
+	// Game thread only. Dummy graphs nodes were spawned into.
+	int32 GraphsUsed = 0;
+	// Game thread only. Nodes not spawned again because they were already documented.
+	int32 DuplicateNodesSkipped = 0;
 	//
 };
 
@@ -8,6 +8,111 @@
 #include "Misc/FileHelper.h"
 #include "Misc/Optional.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+namespace DocGenJsonOutput
+{
+	static const TCHAR* CacheFileName = TEXT("consolidation.bin");
+	static const uint32 CacheMagic = 0x4B44474A;
+	// Bump whenever what is extracted from the intermediate files changes
+	static const int32 CacheVersion = 1;
+	// What the HTML in the output directory was last converted from, written once both conversions succeed
+	static const TCHAR* ConvertedFileName = TEXT("converted.txt");
+
+	FMD5Hash HashBytes(TArray<uint8> const& Bytes)
+	{
+		FMD5 Md5;
+		Md5.Update(Bytes.GetData(), Bytes.Num());
+		FMD5Hash Hash;
+		Hash.Set(Md5);
+		return Hash;
+	}
+
+	FString WriteCondensed(TSharedRef<FJsonObject> const& Object)
+	{
+		FString Result;
+		auto JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Result);
+		FJsonSerializer::Serialize(Object, JsonWriter);
+		return Result;
+	}
+} // namespace DocGenJsonOutput
+
+void DocGenJsonOutputProcessor::FConsolidationCache::Load(FString const& CacheFile)
+{
+	Entries.Reset();
+	ConsolidatedHash = FMD5Hash();
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*CacheFile));
+	if (!Reader.IsValid())
+	{
+		return;
+	}
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*Reader << Magic << Version;
+	if (Reader->IsError() || Magic != DocGenJsonOutput::CacheMagic || Version != DocGenJsonOutput::CacheVersion)
+	{
+		return;
+	}
+
+	*Reader << ConsolidatedHash;
+	int32 NumEntries = 0;
+	*Reader << NumEntries;
+	for (int32 Index = 0; Index < NumEntries && !Reader->IsError(); ++Index)
+	{
+		FString FilePath;
+		FEntry Entry;
+		*Reader << FilePath << Entry.Size << Entry.TimeStamp << Entry.Hash << Entry.Fragment;
+		Entries.Add(MoveTemp(FilePath), MoveTemp(Entry));
+	}
+	if (Reader->IsError())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to read consolidation cache %s, consolidating from scratch"),
+			   *CacheFile);
+		Entries.Reset();
+		ConsolidatedHash = FMD5Hash();
+	}
+}
+
+bool DocGenJsonOutputProcessor::FConsolidationCache::Save(FString const& CacheFile)
+{
+	FString const TempFile = CacheFile + TEXT(".tmp");
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFile));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save consolidation cache %s"), *CacheFile);
+		return false;
+	}
+
+	uint32 Magic = DocGenJsonOutput::CacheMagic;
+	int32 Version = DocGenJsonOutput::CacheVersion;
+	FMD5Hash Hash = ConsolidatedHash;
+	*Writer << Magic << Version << Hash;
+	int32 NumEntries = 0;
+	for (auto const& Pair : Entries)
+	{
+		NumEntries += Pair.Value.bSeen ? 1 : 0;
+	}
+	*Writer << NumEntries;
+	for (auto& Pair : Entries)
+	{
+		if (Pair.Value.bSeen)
+		{
+			FString FilePath = Pair.Key;
+			FEntry& Entry = Pair.Value;
+			*Writer << FilePath << Entry.Size << Entry.TimeStamp << Entry.Hash << Entry.Fragment;
+		}
+	}
+
+	bool const bWritten = Writer->Close() && !Writer->IsError();
+	Writer.Reset();
+	if (!bWritten || !IFileManager::Get().Move(*CacheFile, *TempFile, true, true))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save consolidation cache %s"), *CacheFile);
+		return false;
+	}
+	return true;
+}
 
 FString DocGenJsonOutputProcessor::Quote(const FString& In)
 {
@@ -49,105 +154,96 @@ TOptional<FString> DocGenJsonOutputProcessor::GetObjectStringField(const TShared
 TOptional<TArray<FString>> DocGenJsonOutputProcessor::GetNamesFromFileAtLocation(const FString& NameType,
 																				 const FString& ClassFile)
 {
-	TSharedPtr<FJsonObject> ParsedClass = LoadFileToJson(ClassFile);
-	if (!ParsedClass)
-	{
-		return {};
-	}
-
-	if (ParsedClass->HasTypedField<EJson::Array>(NameType))
-	{
+	// Only the names are kept, rather than everything the class file says about each node
+	TSharedPtr<FJsonObject> Names = LoadFragment(ClassFile, [&](TSharedPtr<FJsonObject> const& ParsedClass) {
 		TArray<FString> NodeNames;
-		for (const auto& Value : ParsedClass->GetArrayField(NameType))
+		if (ParsedClass->HasTypedField<EJson::Array>(NameType))
 		{
-			TOptional<FString> FuncID = GetObjectStringField(Value, "id");
-			if (FuncID.IsSet())
+			for (const auto& Value : ParsedClass->GetArrayField(NameType))
 			{
-				NodeNames.Add(FuncID.GetValue());
+				TOptional<FString> FuncID = GetObjectStringField(Value, "id");
+				if (FuncID.IsSet())
+				{
+					NodeNames.Add(FuncID.GetValue());
+				}
 			}
 		}
-		return NodeNames;
-	}
-	else if (ParsedClass->HasTypedField<EJson::Object>(NameType))
-	{
-		TArray<FString> NodeNames;
-		for (const auto& Node : ParsedClass->GetObjectField(NameType)->Values)
+		else if (ParsedClass->HasTypedField<EJson::Object>(NameType))
 		{
-			TOptional<FString> Name = GetObjectStringField(Node.Value, "id");
-			if (Name.IsSet())
+			for (const auto& Node : ParsedClass->GetObjectField(NameType)->Values)
 			{
-				NodeNames.Add(Name.GetValue());
+				TOptional<FString> Name = GetObjectStringField(Node.Value, "id");
+				if (Name.IsSet())
+				{
+					NodeNames.Add(Name.GetValue());
+				}
 			}
 		}
-		return NodeNames;
-	}
-	else if (ParsedClass->HasTypedField<EJson::Null>(NameType))
+		else if (!ParsedClass->HasTypedField<EJson::Null>(NameType))
+		{
+			return TSharedPtr<FJsonObject>();
+		}
+		TSharedPtr<FJsonObject> Fragment = MakeShared<FJsonObject>();
+		Fragment->SetStringArrayField(NameType, NodeNames);
+		return Fragment;
+	});
+
+	TArray<FString> NodeNames;
+	if (!Names || !Names->TryGetStringArrayField(NameType, NodeNames))
 	{
-		return TArray<FString>();
+		return {};
 	}
-	return {};
+	return NodeNames;
 }
 
 TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseNodeFile(const FString& NodeFilePath)
 {
-	TSharedPtr<FJsonObject> ParsedNode = LoadFileToJson(NodeFilePath);
-	if (!ParsedNode)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-
-	CopyJsonField("inputs", ParsedNode, OutNode);
-	CopyJsonField("outputs", ParsedNode, OutNode);
-	CopyJsonField("rawsignature", ParsedNode, OutNode);
-	CopyJsonField("class_id", ParsedNode, OutNode);
-	CopyJsonField("doxygen", ParsedNode, OutNode);
-	CopyJsonField("imgpath", ParsedNode, OutNode);
-	CopyJsonField("shorttitle", ParsedNode, OutNode);
-	CopyJsonField("fulltitle", ParsedNode, OutNode);
-	CopyJsonField("static", ParsedNode, OutNode);
-	CopyJsonField("autocast", ParsedNode, OutNode);
-	CopyJsonField("funcname", ParsedNode, OutNode);
-	return OutNode;
+	return LoadFragment(NodeFilePath, [this](TSharedPtr<FJsonObject> const& ParsedNode) {
+		TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+
+		CopyJsonField("inputs", ParsedNode, OutNode);
+		CopyJsonField("outputs", ParsedNode, OutNode);
+		CopyJsonField("rawsignature", ParsedNode, OutNode);
+		CopyJsonField("class_id", ParsedNode, OutNode);
+		CopyJsonField("doxygen", ParsedNode, OutNode);
+		CopyJsonField("imgpath", ParsedNode, OutNode);
+		CopyJsonField("shorttitle", ParsedNode, OutNode);
+		CopyJsonField("fulltitle", ParsedNode, OutNode);
+		CopyJsonField("static", ParsedNode, OutNode);
+		CopyJsonField("autocast", ParsedNode, OutNode);
+		CopyJsonField("funcname", ParsedNode, OutNode);
+		return OutNode;
+	});
 }
 TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseStructFile(const FString& StructFilePath)
 {
-	TSharedPtr<FJsonObject> ParsedStruct = LoadFileToJson(StructFilePath);
-	if (!ParsedStruct)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-	// Reusing the class template for now so renaming id to class_id to be consistent
-	if (TSharedPtr<FJsonValue> Field = ParsedStruct->TryGetField("id"))
-	{
-		OutNode->SetField("class_id", Field);
-	}
+	return LoadFragment(StructFilePath, [this](TSharedPtr<FJsonObject> const& ParsedStruct) {
+		TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+		// Reusing the class template for now so renaming id to class_id to be consistent
+		if (TSharedPtr<FJsonValue> Field = ParsedStruct->TryGetField("id"))
+		{
+			OutNode->SetField("class_id", Field);
+		}
 
-	CopyJsonField("doxygen", ParsedStruct, OutNode);
-	CopyJsonField("display_name", ParsedStruct, OutNode);
-	CopyJsonField("fields", ParsedStruct, OutNode);
-	return OutNode;
+		CopyJsonField("doxygen", ParsedStruct, OutNode);
+		CopyJsonField("display_name", ParsedStruct, OutNode);
+		CopyJsonField("fields", ParsedStruct, OutNode);
+		return OutNode;
+	});
 }
 
 TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseEnumFile(const FString& EnumFilePath)
 {
-	TSharedPtr<FJsonObject> ParsedEnum = LoadFileToJson(EnumFilePath);
-	if (!ParsedEnum)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+	return LoadFragment(EnumFilePath, [this](TSharedPtr<FJsonObject> const& ParsedEnum) {
+		TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
 
-	CopyJsonField("id", ParsedEnum, OutNode);
-	CopyJsonField("doxygen", ParsedEnum, OutNode);
-	CopyJsonField("display_name", ParsedEnum, OutNode);
-	CopyJsonField("values", ParsedEnum, OutNode);
+		CopyJsonField("id", ParsedEnum, OutNode);
+		CopyJsonField("doxygen", ParsedEnum, OutNode);
+		CopyJsonField("display_name", ParsedEnum, OutNode);
+		CopyJsonField("values", ParsedEnum, OutNode);
 
-	return OutNode;
+		return OutNode;
+	});
 }
 
 void DocGenJsonOutputProcessor::CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode,
@@ -190,12 +286,13 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConvertJsonToAdoc(FStri
 		{
 			bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
 
-			/*			if(!bProcessFinished && Warn->ReceivedUserCancel())
+			if (!bProcessFinished && bCancelRequested)
 			{
-			FPlatformProcess::TerminateProc(ProcessHandle);
-			bProcessFinished = true;
+				FPlatformProcess::TerminateProc(Proc, true);
+				FPlatformProcess::CloseProc(Proc);
+				FPlatformProcess::ClosePipe(PipeRead, PipeWrite);
+				return EIntermediateProcessingResult::Cancelled;
 			}
-			*/
 			BufferedText += FPlatformProcess::ReadPipe(PipeRead);
 			int32 EndOfLineIdx;
 			while (BufferedText.FindChar('\n', EndOfLineIdx))
@@ -255,12 +352,13 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConvertAdocToHTML(FStri
 		{
 			bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
 
-			/*			if(!bProcessFinished && Warn->ReceivedUserCancel())
+			if (!bProcessFinished && bCancelRequested)
 			{
-			FPlatformProcess::TerminateProc(ProcessHandle);
-			bProcessFinished = true;
+				FPlatformProcess::TerminateProc(Proc, true);
+				FPlatformProcess::CloseProc(Proc);
+				FPlatformProcess::ClosePipe(PipeRead, PipeWrite);
+				return EIntermediateProcessingResult::Cancelled;
 			}
-			*/
 			BufferedText += FPlatformProcess::ReadPipe(PipeRead);
 
 			int32 EndOfLineIdx;
@@ -332,6 +430,15 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ProcessIntermediateDocs
 																				 FString const& DocTitle,
 																				 bool bCleanOutput)
 {
+	// Released once consolidated, rather than held between runs
+	FString const CacheFile = IntermediateDir / DocGenJsonOutput::CacheFileName;
+	Cache = MakeShared<FConsolidationCache>();
+	Cache->Load(CacheFile);
+	ON_SCOPE_EXIT
+	{
+		Cache.Reset();
+	};
+
 	TSharedPtr<FJsonObject> ParsedIndex = LoadFileToJson(IntermediateDir / "index.json");
 
 	TSharedPtr<FJsonObject> ConsolidatedOutput = InitializeMainOutputFromIndex(ParsedIndex);
@@ -357,20 +464,66 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ProcessIntermediateDocs
 		return EnumResult;
 	}
 
+	UE_LOG(LogKantanDocGen, Display, TEXT("Consolidated %d intermediate files, %d of them changed since the last run"),
+		   Cache->NumParsed + Cache->NumReused, Cache->NumParsed);
+
 	FString Result;
 	auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
 	FJsonSerializer::Serialize(ConsolidatedOutput.ToSharedRef(), JsonWriter);
 
-	if (!FFileHelper::SaveStringToFile(Result, *(IntermediateDir / "consolidated.json"),
-									   FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	FString const ConsolidatedPath = IntermediateDir / "consolidated.json";
+	FMD5Hash ConsolidatedHash;
+	{
+		FTCHARToUTF8 Utf8(*Result);
+		FMD5 Md5;
+		Md5.Update(reinterpret_cast<uint8 const*>(Utf8.Get()), Utf8.Length());
+		ConsolidatedHash.Set(Md5);
+	}
+	if (ConsolidatedHash == Cache->ConsolidatedHash && IFileManager::Get().FileExists(*ConsolidatedPath))
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Consolidated docs unchanged, keeping %s"), *ConsolidatedPath);
+	}
+	else if (FFileHelper::SaveStringToFile(Result, *ConsolidatedPath,
+										   FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		Cache->ConsolidatedHash = ConsolidatedHash;
+	}
+	else
 	{
+		IFileManager::Get().Delete(*CacheFile, false, false, true);
 		return EIntermediateProcessingResult::DiskWriteFailure;
 	}
-	if (ConvertJsonToAdoc(IntermediateDir) == EIntermediateProcessingResult::Success)
+	// Files that are no longer part of the docs are forgotten. The cache isn't needed for the conversions.
+	Cache->Save(CacheFile);
+	Cache.Reset();
+
+	// The conversions cost far more than consolidating, so they are skipped if their input and template haven't
+	// changed since the HTML was last written
+	FString const ConvertedPath = IntermediateDir / DocGenJsonOutput::ConvertedFileName;
+	FString const ConvertedFrom = LexToString(ConsolidatedHash) + TEXT("\t") + TemplatePath.FilePath + TEXT("\t") +
+								  IFileManager::Get().GetTimeStamp(*TemplatePath.FilePath).ToString();
+	FString LastConvertedFrom;
+	if (FFileHelper::LoadFileToString(LastConvertedFrom, *ConvertedPath) && LastConvertedFrom == ConvertedFrom &&
+		IFileManager::Get().FileExists(*(OutputDir / "documentation.html")))
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("Consolidated docs unchanged, keeping %s"),
+			   *(OutputDir / "documentation.html"));
+		return EIntermediateProcessingResult::Success;
+	}
+	IFileManager::Get().Delete(*ConvertedPath, false, false, true);
+
+	EIntermediateProcessingResult const AdocResult = ConvertJsonToAdoc(IntermediateDir);
+	if (AdocResult == EIntermediateProcessingResult::Success)
 	{
-		return ConvertAdocToHTML(IntermediateDir, OutputDir);
+		EIntermediateProcessingResult const HtmlResult = ConvertAdocToHTML(IntermediateDir, OutputDir);
+		if (HtmlResult == EIntermediateProcessingResult::Success)
+		{
+			FFileHelper::SaveStringToFile(ConvertedFrom, *ConvertedPath);
+		}
+		return HtmlResult;
 	}
-	return EIntermediateProcessingResult::UnknownError;
+	return AdocResult == EIntermediateProcessingResult::Cancelled ? AdocResult
+																  : EIntermediateProcessingResult::UnknownError;
 }
 
 EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
@@ -388,6 +541,11 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateClasses(TSha
 
 	for (const auto& ClassName : ClassNames.GetValue())
 	{
+		if (bCancelRequested)
+		{
+			return EIntermediateProcessingResult::Cancelled;
+		}
+
 		const FString ClassFilePath = IntermediateDir / ClassName / ClassName + ".json";
 		TOptional<TArray<FString>> NodeNames = GetNamesFromFileAtLocation("nodes", ClassFilePath);
 		if (!NodeNames.IsSet())
@@ -410,8 +568,8 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateClasses(TSha
 						FString SourceImagePath = IntermediateDir / ClassName / "nodes" / RelImagePath;
 						SourceImagePath =
 							IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SourceImagePath);
-						IFileManager::Get().Copy(*(OutputDir / "img" / FPaths::GetCleanFilename(RelImagePath)),
-												 *SourceImagePath, true);
+						CopyImageIfChanged(SourceImagePath,
+										   OutputDir / "img" / FPaths::GetCleanFilename(RelImagePath));
 					}
 					bool FunctionIsStatic = false;
 					NodeJson->TryGetBoolField("static", FunctionIsStatic);
@@ -526,6 +684,11 @@ TOptional<TArray<FString>> DocGenJsonOutputProcessor::GetNamesFromIndexFile(cons
 	}
 }
 
+void DocGenJsonOutputProcessor::Cancel()
+{
+	bCancelRequested = true;
+}
+
 TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::LoadFileToJson(FString const& FilePath)
 {
 	FString IndexFileString;
@@ -533,8 +696,72 @@ TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::LoadFileToJson(FString const&
 	{
 		return nullptr;
 	}
+	return ParseJsonString(IndexFileString);
+}
 
-	TSharedPtr<FJsonStringReader> TopLevelJson = FJsonStringReader::Create(IndexFileString);
+TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::LoadFragment(
+	FString const& FilePath, TFunctionRef<TSharedPtr<FJsonObject>(TSharedPtr<FJsonObject> const&)> Extract)
+{
+	if (!Cache.IsValid())
+	{
+		TSharedPtr<FJsonObject> ParsedFile = LoadFileToJson(FilePath);
+		return ParsedFile ? Extract(ParsedFile) : nullptr;
+	}
+
+	FFileStatData const Stat = IFileManager::Get().GetStatData(*FilePath);
+	FConsolidationCache::FEntry* Entry = Cache->Entries.Find(FilePath);
+	bool bReuse = Entry && !Entry->Fragment.IsEmpty() && Stat.bIsValid && Stat.FileSize == Entry->Size &&
+				  Stat.ModificationTime == Entry->TimeStamp;
+
+	// Rewritten files often have the same contents, as when a full run regenerates unchanged nodes
+	if (!bReuse)
+	{
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+		{
+			Cache->Entries.Remove(FilePath);
+			return nullptr;
+		}
+		FMD5Hash const Hash = DocGenJsonOutput::HashBytes(Bytes);
+		bReuse = Entry && !Entry->Fragment.IsEmpty() && Entry->Hash == Hash;
+		if (!bReuse)
+		{
+			FString FileString;
+			FFileHelper::BufferToString(FileString, Bytes.GetData(), Bytes.Num());
+			TSharedPtr<FJsonObject> ParsedFile = ParseJsonString(FileString);
+			TSharedPtr<FJsonObject> Fragment = ParsedFile ? Extract(ParsedFile) : nullptr;
+			if (!Fragment)
+			{
+				Cache->Entries.Remove(FilePath);
+				return nullptr;
+			}
+			Entry = &Cache->Entries.FindOrAdd(FilePath);
+			Entry->Hash = Hash;
+			Entry->Fragment = DocGenJsonOutput::WriteCondensed(Fragment.ToSharedRef());
+			Entry->Size = Stat.FileSize;
+			Entry->TimeStamp = Stat.ModificationTime;
+			Entry->bSeen = true;
+			++Cache->NumParsed;
+			return Fragment;
+		}
+		Entry->Size = Stat.FileSize;
+		Entry->TimeStamp = Stat.ModificationTime;
+	}
+
+	TSharedPtr<FJsonObject> Fragment = ParseJsonString(Entry->Fragment);
+	if (!Fragment)
+	{
+		Cache->Entries.Remove(FilePath);
+		return nullptr;
+	}
+	Entry->bSeen = true;
+	++Cache->NumReused;
+	return Fragment;
+}
+
+TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseJsonString(FString const& JsonString)
+{
+	TSharedPtr<FJsonStringReader> TopLevelJson = FJsonStringReader::Create(JsonString);
 	TSharedPtr<FJsonObject> ParsedFile;
 	if (!FJsonSerializer::Deserialize<TCHAR>(*TopLevelJson, ParsedFile, FJsonSerializer::EFlags::None))
 	{
@@ -545,3 +772,31 @@ TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::LoadFileToJson(FString const&
 		return ParsedFile;
 	}
 }
+
+void DocGenJsonOutputProcessor::CopyImageIfChanged(FString const& SourcePath, FString const& DestPath)
+{
+	if (!Cache.IsValid())
+	{
+		IFileManager::Get().Copy(*DestPath, *SourcePath, true);
+		return;
+	}
+
+	FFileStatData const Stat = IFileManager::Get().GetStatData(*SourcePath);
+	FConsolidationCache::FEntry& Entry = Cache->Entries.FindOrAdd(SourcePath);
+	Entry.bSeen = true;
+	if (Stat.bIsValid && Stat.FileSize == Entry.Size && Stat.ModificationTime == Entry.TimeStamp &&
+		IFileManager::Get().FileExists(*DestPath))
+	{
+		return;
+	}
+
+	if (IFileManager::Get().Copy(*DestPath, *SourcePath, true) == COPY_OK)
+	{
+		Entry.Size = Stat.FileSize;
+		Entry.TimeStamp = Stat.ModificationTime;
+	}
+	else
+	{
+		Entry.Size = -1;
+	}
+}
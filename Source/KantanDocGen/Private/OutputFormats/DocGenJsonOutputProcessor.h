@@ -4,11 +4,47 @@
 #include "Containers/UnrealString.h"
 #include "DocGenOutputProcessor.h"
 #include "Engine/EngineTypes.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/DateTime.h"
 #include "Misc/Optional.h"
+#include "Misc/SecureHash.h"
 #include "Templates/SharedPointer.h"
 
 class DocGenJsonOutputProcessor : public IDocGenOutputProcessor
 {
+public:
+	/**
+	 * What the last consolidation of an intermediate directory took from each intermediate file, saved alongside the
+	 * files so that commandlet runs benefit as much as editor ones. A file is only read and parsed again once its
+	 * contents change, so an incremental run that touched a handful of nodes doesn't reconsolidate all of them. Only
+	 * held in memory while consolidating.
+	 */
+	struct FConsolidationCache
+	{
+		struct FEntry
+		{
+			// Stat of the file when it was last read, so unchanged files needn't even be hashed
+			int64 Size = -1;
+			FDateTime TimeStamp;
+			FMD5Hash Hash;
+			// The part of the file consolidation uses, as condensed JSON. Empty for images, which are only tracked to
+			// avoid copying them again.
+			FString Fragment;
+			bool bSeen = false;
+		};
+
+		/** Leaves the cache empty unless the file was saved by this version */
+		void Load(FString const& CacheFile);
+		/** Entries not seen since the cache was loaded are left out */
+		bool Save(FString const& CacheFile);
+
+		TMap<FString, FEntry> Entries;
+		FMD5Hash ConsolidatedHash;
+		int32 NumParsed = 0;
+		int32 NumReused = 0;
+	};
+
+private:
 	FString Quote(const FString& In);
 	TOptional<FString> GetObjectStringField(const TSharedPtr<class FJsonValue> Obj, const FString& FieldName);
 
@@ -27,6 +63,7 @@ class DocGenJsonOutputProcessor : public IDocGenOutputProcessor
 	FFilePath TemplatePath;
 	FDirectoryPath BinaryPath;
 	FFilePath RubyExecutablePath;
+	FThreadSafeBool bCancelRequested;
 
 public:
 	DocGenJsonOutputProcessor(TOptional<FFilePath> TemplatePathOverride, TOptional<FDirectoryPath> BinaryPathOverride,
@@ -34,6 +71,7 @@ public:
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) override;
+	virtual void Cancel() override;
 
 	EIntermediateProcessingResult ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
 													 FString const& IntermediateDir, FString const& OutputDir,
@@ -51,4 +89,18 @@ public:
 	TOptional<TArray<FString>> GetNamesFromIndexFile(const FString& NameType, TSharedPtr<FJsonObject> ParsedIndex);
 
 	TSharedPtr<FJsonObject> LoadFileToJson(FString const& FilePath);
+
+private:
+	static TSharedPtr<FJsonObject> ParseJsonString(FString const& JsonString);
+	/**
+	 * Loads a file and returns the part of it that Extract picks out, which is kept in the cache. While the file is
+	 * unchanged the kept part is returned without reading the file again.
+	 */
+	TSharedPtr<FJsonObject> LoadFragment(FString const& FilePath,
+										 TFunctionRef<TSharedPtr<FJsonObject>(TSharedPtr<FJsonObject> const&)> Extract);
+	/** Copies the image unless it is unchanged since it was last copied and is still in the output directory */
+	void CopyImageIfChanged(FString const& SourcePath, FString const& DestPath);
+
+	// Set for the duration of ProcessIntermediateDocs
+	TSharedPtr<FConsolidationCache> Cache;
 };
\ No newline at end of file
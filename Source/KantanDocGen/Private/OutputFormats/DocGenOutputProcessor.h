@@ -8,6 +8,7 @@ enum EIntermediateProcessingResult : uint8
 	SuccessWithErrors,
 	UnknownError,
 	DiskWriteFailure,
+	Cancelled,
 };
 
 struct IDocGenOutputProcessor
@@ -16,4 +17,6 @@ struct IDocGenOutputProcessor
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) = 0;
+	// Called from another thread to stop ProcessIntermediateDocs as soon as possible, killing any tool it has started
+	virtual void Cancel() {};
 };
\ No newline at end of file
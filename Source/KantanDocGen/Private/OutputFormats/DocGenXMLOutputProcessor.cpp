@@ -1,12 +1,167 @@
 #include "OutputFormats/DocGenXMLOutputProcessor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
 #include "HAL/PlatformProcess.h"
 #include "Interfaces/IPluginManager.h"
 #include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+
+namespace DocGenXMLOutput
+{
+	static const TCHAR* StateFileName = TEXT("xml_output.txt");
+	static const TCHAR* Header = TEXT("KantanDocGenXmlOutput");
+	// Bump whenever the tool or stylesheets change the pages they produce
+	static const TCHAR* Version = TEXT("1");
+
+	static FString MakeRelative(FString const& Path, FString const& Root)
+	{
+		FString Relative = Path.RightChop(Root.Len());
+		Relative.RemoveFromStart(TEXT("/"));
+		Relative.RemoveFromStart(TEXT("\\"));
+		return Relative;
+	}
+
+	// Class, struct or enum directory a file belongs to, empty for the index
+	static FString GetTypeDir(FString const& RelativePath)
+	{
+		int32 Slash = INDEX_NONE;
+		return RelativePath.FindChar(TEXT('/'), Slash) ? RelativePath.Left(Slash) : FString();
+	}
+} // namespace DocGenXMLOutput
 
 EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
 																				FString const& OutputDir,
 																				FString const& DocTitle,
 																				bool bCleanOutput)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	FString const StateFile = IntermediateDir / DocGenXMLOutput::StateFileName;
+
+	FOutputState Previous;
+	bool const bIncremental = !bCleanOutput && LoadOutputState(StateFile, Previous) &&
+							  Previous.OutputDir == OutputDir && Previous.DocTitle == DocTitle &&
+							  FileManager.FileExists(*(OutputDir / Previous.PagesRoot / TEXT("index.html")));
+	// Forgotten until this conversion succeeds, so that a failed one is followed by a full conversion
+	FileManager.Delete(*StateFile, false, true, true);
+
+	FOutputState Current;
+	Current.OutputDir = OutputDir;
+	Current.DocTitle = DocTitle;
+	ScanIntermediateFiles(IntermediateDir, Previous, Current.Files);
+
+	if (!bIncremental)
+	{
+		EIntermediateProcessingResult const Result =
+			RunConversionTool(IntermediateDir, OutputDir, DocTitle, bCleanOutput);
+		if (Result == EIntermediateProcessingResult::Success)
+		{
+			Current.PagesRoot = FindPagesRoot(OutputDir);
+			SaveOutputState(StateFile, Current);
+		}
+		return Result;
+	}
+
+	Current.PagesRoot = Previous.PagesRoot;
+	TArray<FString> Changed;
+	TArray<FString> Removed;
+	for (auto const& Entry : Current.Files)
+	{
+		FSourceFile const* PreviousFile = Previous.Files.Find(Entry.Key);
+		if (PreviousFile == nullptr || PreviousFile->Hash != Entry.Value.Hash)
+		{
+			Changed.Add(Entry.Key);
+		}
+	}
+	for (auto const& Entry : Previous.Files)
+	{
+		if (!Current.Files.Contains(Entry.Key))
+		{
+			Removed.Add(Entry.Key);
+		}
+	}
+	UE_LOG(LogKantanDocGen, Display, TEXT("%d intermediate files changed and %d removed since the last conversion"),
+		   Changed.Num(), Removed.Num());
+
+	EIntermediateProcessingResult Result = EIntermediateProcessingResult::Success;
+	if (Changed.Num() > 0)
+	{
+		// The tool converts everything it is given into an empty directory, so give it just the changed files and
+		// merge its output into the existing pages. The index and the doc of each type with changed files go too,
+		// since the tool expects them alongside.
+		FString const StagingDir = IntermediateDir + TEXT("_Staging");
+		FString const StagingIntermediateDir = StagingDir / TEXT("Intermediate");
+		FString const StagingOutputDir = StagingDir / TEXT("Output");
+		FileManager.DeleteDirectory(*StagingDir, false, true);
+
+		TSet<FString> ToStage(Changed);
+		ToStage.Add(TEXT("index.xml"));
+		for (auto const& Path : Changed)
+		{
+			FString const TypeDir = DocGenXMLOutput::GetTypeDir(Path);
+			if (!TypeDir.IsEmpty() && Current.Files.Contains(TypeDir / TypeDir + TEXT(".xml")))
+			{
+				ToStage.Add(TypeDir / TypeDir + TEXT(".xml"));
+			}
+		}
+		for (auto const& Path : ToStage)
+		{
+			if (FileManager.Copy(*(StagingIntermediateDir / Path), *(IntermediateDir / Path)) != COPY_OK)
+			{
+				Result = EIntermediateProcessingResult::DiskWriteFailure;
+				break;
+			}
+		}
+
+		if (Result == EIntermediateProcessingResult::Success)
+		{
+			Result = RunConversionTool(StagingIntermediateDir, StagingOutputDir, DocTitle, true);
+		}
+		if (Result == EIntermediateProcessingResult::Success)
+		{
+			TArray<FString> Produced;
+			FileManager.FindFilesRecursive(Produced, *StagingOutputDir, TEXT("*"), true, false);
+			for (auto const& Path : Produced)
+			{
+				FString const Relative = DocGenXMLOutput::MakeRelative(Path, StagingOutputDir);
+				if (FileManager.Copy(*(OutputDir / Relative), *Path) != COPY_OK)
+				{
+					Result = EIntermediateProcessingResult::DiskWriteFailure;
+					break;
+				}
+			}
+			UE_LOG(LogKantanDocGen, Display, TEXT("Updated %d output files"), Produced.Num());
+		}
+		FileManager.DeleteDirectory(*StagingDir, false, true);
+	}
+
+	if (Result == EIntermediateProcessingResult::Success)
+	{
+		// Pages mirror the intermediate files they came from, images are copied as they are
+		FString const PagesDir = OutputDir / Current.PagesRoot;
+		TSet<FString> RemovedTypeDirs;
+		for (auto const& Path : Removed)
+		{
+			FString const Page = Path.EndsWith(TEXT(".xml")) ? FPaths::ChangeExtension(Path, TEXT("html")) : Path;
+			FileManager.Delete(*(PagesDir / Page), false, true, true);
+			RemovedTypeDirs.Add(DocGenXMLOutput::GetTypeDir(Path));
+		}
+		for (auto const& TypeDir : RemovedTypeDirs)
+		{
+			if (!TypeDir.IsEmpty() && !FileManager.DirectoryExists(*(IntermediateDir / TypeDir)))
+			{
+				FileManager.DeleteDirectory(*(PagesDir / TypeDir), false, true);
+			}
+		}
+		SaveOutputState(StateFile, Current);
+	}
+	return Result;
+}
+
+EIntermediateProcessingResult DocGenXMLOutputProcessor::RunConversionTool(FString const& IntermediateDir,
+																		  FString const& OutputDir,
+																		  FString const& DocTitle, bool bCleanOutput)
 {
 	auto& PluginManager = IPluginManager::Get();
 	auto Plugin = PluginManager.FindPlugin(TEXT("KantanDocGen"));
@@ -34,6 +189,7 @@ EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(
 		FPlatformProcess::CreateProc(*DocGenToolPath, *Args, true, false, false, nullptr, 0, nullptr, PipeWrite);
 
 	int32 ReturnCode = 0;
+	bool bCancelled = false;
 	if (Proc.IsValid())
 	{
 		FString BufferedText;
@@ -41,12 +197,12 @@ EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(
 		{
 			bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
 
-			/*			if(!bProcessFinished && Warn->ReceivedUserCancel())
+			if (!bProcessFinished && bCancelRequested)
 			{
-			FPlatformProcess::TerminateProc(ProcessHandle);
-			bProcessFinished = true;
+				FPlatformProcess::TerminateProc(Proc, true);
+				bProcessFinished = true;
+				bCancelled = true;
 			}
-			*/
 			BufferedText += FPlatformProcess::ReadPipe(PipeRead);
 
 			int32 EndOfLineIdx;
@@ -68,7 +224,7 @@ EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(
 		FPlatformProcess::CloseProc(Proc);
 		Proc.Reset();
 
-		if (ReturnCode != 0)
+		if (ReturnCode != 0 && !bCancelled)
 		{
 			UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
 		}
@@ -78,6 +234,12 @@ EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(
 	FPlatformProcess::ClosePipe(0, PipeRead);
 	FPlatformProcess::ClosePipe(0, PipeWrite);
 
+	if (bCancelled)
+	{
+		UE_LOG(LogKantanDocGen, Display, TEXT("KantanDocGen tool cancelled"));
+		return EIntermediateProcessingResult::Cancelled;
+	}
+
 	switch (ReturnCode)
 	{
 		case 0:
@@ -90,3 +252,106 @@ EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(
 			return EIntermediateProcessingResult::SuccessWithErrors;
 	}
 }
+
+void DocGenXMLOutputProcessor::Cancel()
+{
+	bCancelRequested = true;
+}
+
+void DocGenXMLOutputProcessor::ScanIntermediateFiles(FString const& IntermediateDir, FOutputState const& Previous,
+													 TMap<FString, FSourceFile>& OutFiles) const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.IterateDirectoryStatRecursively(
+		*IntermediateDir, [&](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData) {
+			FString const Path = FilenameOrDirectory;
+			if (StatData.bIsDirectory || !(Path.EndsWith(TEXT(".xml")) || Path.EndsWith(TEXT(".png"))))
+			{
+				return true;
+			}
+
+			FString const Relative = DocGenXMLOutput::MakeRelative(Path, IntermediateDir);
+			FSourceFile File;
+			File.Size = StatData.FileSize;
+			File.TimeStamp = StatData.ModificationTime.GetTicks();
+			FSourceFile const* PreviousFile = Previous.Files.Find(Relative);
+			if (PreviousFile && PreviousFile->Size == File.Size && PreviousFile->TimeStamp == File.TimeStamp)
+			{
+				File.Hash = PreviousFile->Hash;
+			}
+			else
+			{
+				File.Hash = LexToString(FMD5Hash::HashFile(*Path));
+			}
+			OutFiles.Add(Relative, MoveTemp(File));
+			return !bCancelRequested;
+		});
+}
+
+bool DocGenXMLOutputProcessor::LoadOutputState(FString const& StateFile, FOutputState& OutState)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *StateFile))
+	{
+		return false;
+	}
+
+	TArray<FString> Fields;
+	if (Lines.Num() == 0 || Lines[0].ParseIntoArray(Fields, TEXT("\t"), false) != 5 ||
+		Fields[0] != DocGenXMLOutput::Header || Fields[1] != DocGenXMLOutput::Version)
+	{
+		return false;
+	}
+	OutState.OutputDir = Fields[2];
+	OutState.DocTitle = Fields[3];
+	OutState.PagesRoot = Fields[4];
+
+	for (int32 Index = 1; Index < Lines.Num(); ++Index)
+	{
+		if (Lines[Index].ParseIntoArray(Fields, TEXT("\t"), false) != 4)
+		{
+			continue;
+		}
+		FSourceFile& File = OutState.Files.Add(Fields[0]);
+		LexFromString(File.Size, *Fields[1]);
+		LexFromString(File.TimeStamp, *Fields[2]);
+		File.Hash = Fields[3];
+	}
+	return true;
+}
+
+bool DocGenXMLOutputProcessor::SaveOutputState(FString const& StateFile, FOutputState const& State)
+{
+	FString Contents = FString::Printf(TEXT("%s\t%s\t%s\t%s\t%s\n"), DocGenXMLOutput::Header,
+									   DocGenXMLOutput::Version, *State.OutputDir, *State.DocTitle, *State.PagesRoot);
+	for (auto const& Entry : State.Files)
+	{
+		Contents += FString::Printf(TEXT("%s\t%lld\t%lld\t%s\n"), *Entry.Key, Entry.Value.Size,
+									Entry.Value.TimeStamp, *Entry.Value.Hash);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Contents, *StateFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save %s, the next conversion will be a full one"),
+			   *StateFile);
+		return false;
+	}
+	return true;
+}
+
+FString DocGenXMLOutputProcessor::FindPagesRoot(FString const& OutputDir)
+{
+	TArray<FString> Indices;
+	IFileManager::Get().FindFilesRecursive(Indices, *OutputDir, TEXT("index.html"), true, false);
+	FString PagesRoot;
+	int32 BestLength = MAX_int32;
+	for (auto const& Index : Indices)
+	{
+		if (Index.Len() < BestLength)
+		{
+			BestLength = Index.Len();
+			PagesRoot = DocGenXMLOutput::MakeRelative(FPaths::GetPath(Index), OutputDir);
+		}
+	}
+	return PagesRoot;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "HAL/ThreadSafeBool.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
 
 class DocGenXMLOutputProcessor : public IDocGenOutputProcessor
@@ -7,4 +8,37 @@ public:
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) override;
-};
\ No newline at end of file
+	virtual void Cancel() override;
+
+protected:
+	// An intermediate file as of the last conversion, keyed on its path relative to the intermediate directory
+	struct FSourceFile
+	{
+		int64 Size = -1;
+		int64 TimeStamp = 0;
+		FString Hash;
+	};
+
+	// What the output directory was last converted from, so only what changed since needs converting again
+	struct FOutputState
+	{
+		FString OutputDir;
+		FString DocTitle;
+		// Where the tool put index.html, relative to the output directory. The rest of the pages mirror the
+		// intermediate directory below it.
+		FString PagesRoot;
+		TMap<FString, FSourceFile> Files;
+	};
+
+	EIntermediateProcessingResult RunConversionTool(FString const& IntermediateDir, FString const& OutputDir,
+													FString const& DocTitle, bool bCleanOutput);
+	/** Hashes the xml and images of the intermediate directory, reusing the hashes of files with the same stat */
+	void ScanIntermediateFiles(FString const& IntermediateDir, FOutputState const& Previous,
+							   TMap<FString, FSourceFile>& OutFiles) const;
+	static bool LoadOutputState(FString const& StateFile, FOutputState& OutState);
+	static bool SaveOutputState(FString const& StateFile, FOutputState const& State);
+	static FString FindPagesRoot(FString const& OutputDir);
+
+protected:
+	FThreadSafeBool bCancelRequested;
+};